@@ -17,14 +17,18 @@
 
 static void bump_reason (struct ring *ring, struct watcher *watcher) {
   assert (watcher->redundant);
-  watcher->used = MAX_USED;
+  struct watcher_usage *usage = watcher_to_usage (ring, watcher);
+  usage->used = MAX_USED;
+  unsigned source = usage->source;
+  if (source != ring->id)
+    ring->sources[source].used++;
   unsigned new_glue = recompute_glue (ring, watcher);
-  if (new_glue < watcher->glue)
+  if (new_glue < usage->glue)
     promote_watcher (ring, watcher, new_glue);
   else
-    new_glue = watcher->glue;
-  assert (watcher->glue);
-  assert (watcher->glue <= MAX_GLUE);
+    new_glue = usage->glue;
+  assert (usage->glue);
+  assert (usage->glue <= MAX_GLUE);
   unsigned stable = ring->stable;
   ring->statistics.usage[stable].glue[new_glue]++;
   ring->statistics.usage[stable].bumped++;
@@ -392,7 +396,7 @@ bool analyze (struct ring *ring, struct watch *reason) {
     struct watch *learned;
     if (size == 2) {
       assert (VAR (other)->level == jump);
-      learned = new_local_binary_clause (ring, true, not_uip, other);
+      learned = new_learned_binary_clause (ring, not_uip, other);
       trace_add_binary (&ring->trace, not_uip, other);
       if (ring->options.eagerly_subsume)
         eagerly_subsume_last_learned (ring);
@@ -409,7 +413,7 @@ bool analyze (struct ring *ring, struct watch *reason) {
         *p = other;
       }
       struct clause *learned_clause =
-          new_large_clause (size, literals, true, glue);
+          new_large_clause (ring->arena, size, literals, true, glue);
       learned_clause->origin = ring->id;
       LOGCLAUSE (learned_clause, "new");
       learned =
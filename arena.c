@@ -0,0 +1,145 @@
+#include "arena.h"
+#include "allocate.h"
+#include "utilities.h"
+
+#include <assert.h>
+#include <string.h>
+
+// Size classes in bytes including the block header word, which stores the
+// owning arena with the size class in the lower (cache line aligned) bits.
+
+static const unsigned arena_class_bytes[SIZE_ARENA_CLASSES] = {
+    32,  40,  48,  56,  64,  80,  96,  112, 128, 160,  192,
+    224, 256, 320, 384, 448, 512, 640, 768, 896, 1024, 1280};
+
+#define CLASS_MASK ((uintptr_t) (CACHE_LINE_SIZE - 1))
+
+static unsigned arena_class (size_t bytes) {
+  unsigned class = 0;
+  while (class != SIZE_ARENA_CLASSES && arena_class_bytes[class] < bytes)
+    class++;
+  return class;
+}
+
+struct arena *new_arenas (unsigned size) {
+  assert (size);
+  assert (SIZE_ARENA_CLASSES <= CLASS_MASK);
+  struct arena *arenas =
+      allocate_aligned_array (CACHE_LINE_SIZE, size, sizeof *arenas);
+  memset (arenas, 0, size * sizeof *arenas);
+  return arenas;
+}
+
+void delete_arenas (struct arena *arenas, unsigned size) {
+  for (struct arena *a = arenas; a != arenas + size; a++) {
+    void *next;
+    for (void *chunk = a->chunks; chunk; chunk = next) {
+      next = *(void **) chunk;
+      free (chunk);
+    }
+  }
+  deallocate_aligned (CACHE_LINE_SIZE, arenas);
+}
+
+static void push_free_block (struct arena *arena, unsigned class,
+                             uintptr_t *block) {
+  assert (class < SIZE_ARENA_CLASSES);
+  void **link = (void **) (block + 1);
+  *link = arena->free[class];
+  arena->free[class] = block;
+  size_t bytes = arena_class_bytes[class];
+  assert (bytes <= arena->statistics.live);
+  arena->statistics.live -= bytes;
+  arena->statistics.free += bytes;
+}
+
+static void reclaim_remote_blocks (struct arena *arena) {
+  uintptr_t remote =
+      atomic_exchange_explicit (&arena->remote, 0, memory_order_acquire);
+  while (remote) {
+    uintptr_t *block = (uintptr_t *) remote;
+    remote = *(uintptr_t *) (block + 1);
+    assert ((struct arena *) (*block & ~CLASS_MASK) == arena);
+    unsigned class = *block & CLASS_MASK;
+    push_free_block (arena, class, block);
+    arena->statistics.deallocated++;
+    arena->statistics.remote++;
+  }
+}
+
+static void recycle_chunk_tail (struct arena *arena) {
+  size_t remaining = arena->end - arena->top;
+  unsigned class = SIZE_ARENA_CLASSES;
+  while (remaining >= arena_class_bytes[0]) {
+    while (arena_class_bytes[class - 1] > remaining)
+      class--;
+    uintptr_t *block = (uintptr_t *) arena->top;
+    size_t bytes = arena_class_bytes[class - 1];
+    *block = (uintptr_t) arena | (class - 1);
+    arena->top += bytes;
+    arena->statistics.live += bytes;
+    push_free_block (arena, class - 1, block);
+    remaining -= bytes;
+  }
+}
+
+static void new_chunk (struct arena *arena) {
+  recycle_chunk_tail (arena);
+  char *chunk = allocate_block (ARENA_CHUNK_SIZE);
+  *(void **) chunk = arena->chunks;
+  arena->chunks = chunk;
+  arena->top = chunk + sizeof (void *);
+  arena->end = chunk + ARENA_CHUNK_SIZE;
+  arena->statistics.chunks++;
+  arena->statistics.bytes += ARENA_CHUNK_SIZE;
+}
+
+void *allocate_from_arena (struct arena *arena, size_t bytes) {
+  size_t needed = bytes + sizeof (uintptr_t);
+  unsigned class = arena_class (needed);
+  uintptr_t *block;
+  arena->statistics.allocated++;
+  if (class == LARGE_ARENA_CLASS) {
+    arena->statistics.large++;
+    block = allocate_block (needed);
+  } else {
+    if (!arena->free[class])
+      reclaim_remote_blocks (arena);
+    size_t class_bytes = arena_class_bytes[class];
+    if ((block = arena->free[class])) {
+      arena->free[class] = *(void **) (block + 1);
+      assert (class_bytes <= arena->statistics.free);
+      arena->statistics.free -= class_bytes;
+      arena->statistics.reused++;
+    } else {
+      if ((size_t) (arena->end - arena->top) < class_bytes)
+        new_chunk (arena);
+      block = (uintptr_t *) arena->top;
+      arena->top += class_bytes;
+    }
+    arena->statistics.live += class_bytes;
+  }
+  *block = (uintptr_t) arena | class;
+  return block + 1;
+}
+
+void deallocate_to_arena (struct arena *arena, void *ptr) {
+  uintptr_t *block = (uintptr_t *) ptr - 1;
+  struct arena *owner = (struct arena *) (*block & ~CLASS_MASK);
+  unsigned class = *block & CLASS_MASK;
+  if (class == LARGE_ARENA_CLASS)
+    free (block);
+  else if (owner == arena) {
+    push_free_block (arena, class, block);
+    arena->statistics.deallocated++;
+  } else {
+    uintptr_t *link = (uintptr_t *) ptr;
+    uintptr_t remote =
+        atomic_load_explicit (&owner->remote, memory_order_relaxed);
+    do
+      *link = remote;
+    while (!atomic_compare_exchange_weak_explicit (
+        &owner->remote, &remote, (uintptr_t) block, memory_order_release,
+        memory_order_relaxed));
+  }
+}
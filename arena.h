@@ -0,0 +1,47 @@
+#ifndef _arena_h_INCLUDED
+#define _arena_h_INCLUDED
+
+#include "options.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// Each thread allocates its large clauses from its own arena.  Blocks are
+// carved from large chunks and recycled through per size-class free lists.
+// Clauses are shared among rings and thus might be dereferenced and
+// deleted by another thread than the one which allocated it.  In that case
+// the block is pushed lock-free on the 'remote' list of the owning arena,
+// which is only reclaimed lazily by its owner during later allocations.
+
+#define SIZE_ARENA_CLASSES 22
+#define LARGE_ARENA_CLASS SIZE_ARENA_CLASSES
+#define ARENA_CHUNK_SIZE (1u << 20)
+
+struct arena_statistics {
+  uint64_t allocated;
+  uint64_t deallocated;
+  uint64_t large;
+  uint64_t remote;
+  uint64_t reused;
+  size_t chunks;
+  size_t bytes;
+  size_t live;
+  size_t free;
+};
+
+struct arena {
+  _Alignas (CACHE_LINE_SIZE) atomic_uintptr_t remote;
+  char *top, *end;
+  void *chunks;
+  void *free[SIZE_ARENA_CLASSES];
+  struct arena_statistics statistics;
+};
+
+struct arena *new_arenas (unsigned);
+void delete_arenas (struct arena *, unsigned);
+
+void *allocate_from_arena (struct arena *, size_t bytes);
+void deallocate_to_arena (struct arena *, void *);
+
+#endif
@@ -25,6 +25,38 @@ static void unassign (struct ring *ring, unsigned lit) {
   }
 }
 
+void clear_saved_trail (struct ring *ring) {
+  struct saved_trail *saved = &ring->saved_trail;
+  CLEAR (*saved);
+  saved->head = 0;
+}
+
+// With trail saving enabled the unassigned literals are saved together
+// with their reasons in the original assignment order (with decisions
+// having a zero reason).  If the first saved literal is assigned again
+// during search, propagation replays the following saved literals as
+// long as their reasons are still falsified (see 'propagate.c').
+
+static void save_trail (struct ring *ring, unsigned *begin) {
+  struct saved_trail *saved = &ring->saved_trail;
+  CLEAR (*saved);
+  saved->head = 0;
+  struct variable *variables = ring->variables;
+  signed char *values = ring->values;
+  unsigned *end = ring->trail.end;
+  for (unsigned *p = begin; p != end; p++) {
+    unsigned lit = *p;
+    if (values[lit])
+      continue;
+    struct saved_assignment sa;
+    sa.lit = lit;
+    sa.reason = variables[IDX (lit)].reason;
+    PUSH (*saved, sa);
+  }
+  ring->statistics.trail.saved += SIZE (*saved);
+  LOG ("saved %zu literals of backtracked trail", SIZE (*saved));
+}
+
 void backtrack (struct ring *ring, unsigned new_level) {
   assert (ring->level > new_level);
   LOG ("backtracking to decision level %u", new_level);
@@ -44,6 +76,8 @@ void backtrack (struct ring *ring, unsigned new_level) {
         break;
     }
   }
+  if (ring->options.trail_saving && ring->context == SEARCH_CONTEXT)
+    save_trail (ring, t);
   trail->end = trail->propagate = t;
   ring->level = new_level;
   LOG ("backtracked to decision level %u", new_level);
@@ -3,6 +3,7 @@
 
 struct ring;
 void backtrack (struct ring *, unsigned level);
+void clear_saved_trail (struct ring *);
 void update_best_and_target_phases (struct ring *);
 
 #endif
@@ -0,0 +1,545 @@
+#include "bva.h"
+#include "allocate.h"
+#include "message.h"
+#include "ruler.h"
+#include "simplify.h"
+#include "utilities.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+// Bounded variable addition factors out repeated clause patterns.  If all
+// the clauses 'l_i | C_j' for literals 'l_1, ..., l_n' and (sub-)clauses
+// 'C_1, ..., C_m' are present they are replaced by the clauses 'x | l_i'
+// and '-x | C_j' with a fresh variable 'x', which removes 'n * m - n - m'
+// clauses.  Starting with a literal 'l' and all its occurrences 'l | C_j'
+// we greedily add the literal 'l_i' which occurs in most clauses 'l_i |
+// C_j' as long as the reduction increases.  The new clauses are traced
+// before the replaced clauses are deleted with the fresh literal first,
+// since they are RAT on it and the DRAT proof thus stays valid.
+
+// Fresh variables do not exist in the original formula.  Therefore this
+// pass is only run during initial simplification before the rings are
+// cloned (as all variables and arrays indexed by them still live in the
+// ruler at that point) and not if clauses are exchanged with other
+// processes or peers, which all have to agree on the variables.  Fresh
+// variables are not eliminated either, since that would just undo the
+// addition (with a bound large enough).
+
+struct bva {
+  struct simplifier *simplifier;
+  unsigned capacity;
+  unsigned stamp;
+  unsigned *counts;
+  unsigned *stamps;
+  struct unsigneds literals;
+  struct unsigneds touched;
+  struct clauses clauses;
+  uint64_t ticks;
+};
+
+static bool bva_ticks_limit_hit (struct bva *bva) {
+  struct ruler *ruler = bva->simplifier->ruler;
+  uint64_t ticks = ruler->statistics.ticks.bva + bva->ticks;
+  return ticks > ruler->limits.bva;
+}
+
+static void flush_bva_ticks (struct bva *bva) {
+  struct ruler *ruler = bva->simplifier->ruler;
+  ruler->statistics.ticks.bva += bva->ticks;
+  bva->ticks = 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+// All arrays indexed by variables or literals are enlarged geometrically
+// to avoid reallocating them for every single fresh variable.  Note that
+// all units have been propagated and flushed, but are still on the trail.
+
+static void *enlarge_and_clear (void *ptr, size_t old_bytes,
+                                size_t new_bytes) {
+  char *res = reallocate_block (ptr, new_bytes);
+  if (old_bytes < new_bytes)
+    memset (res + old_bytes, 0, new_bytes - old_bytes);
+  return res;
+}
+
+static void enlarge_variables (struct bva *bva) {
+  struct simplifier *simplifier = bva->simplifier;
+  struct ruler *ruler = simplifier->ruler;
+  unsigned old_capacity = bva->capacity;
+  unsigned new_capacity = old_capacity + old_capacity / 8 + 64;
+  if (new_capacity > MAX_VAR)
+    new_capacity = MAX_VAR;
+  assert (old_capacity < new_capacity);
+  ROG ("enlarging variables capacity from %u to %u", old_capacity,
+       new_capacity);
+
+  size_t old_literals = 2 * (size_t) old_capacity;
+  size_t new_literals = 2 * (size_t) new_capacity;
+
+  ruler->eliminate =
+      enlarge_and_clear (ruler->eliminate, old_capacity, new_capacity);
+  ruler->subsume =
+      enlarge_and_clear (ruler->subsume, old_capacity, new_capacity);
+  ruler->occurrences = enlarge_and_clear (
+      ruler->occurrences, old_literals * sizeof *ruler->occurrences,
+      new_literals * sizeof *ruler->occurrences);
+  ruler->values = enlarge_and_clear ((void *) ruler->values, old_literals,
+                                     new_literals);
+
+  struct ruler_trail *units = &ruler->units;
+  size_t propagated = units->propagate - units->begin;
+  size_t assigned = units->end - units->begin;
+  units->begin = reallocate_block (units->begin,
+                                   new_capacity * sizeof *units->begin);
+  units->propagate = units->begin + propagated;
+  units->end = units->begin + assigned;
+
+  if (ruler->store.chunks)
+    ruler->store.chunks = enlarge_and_clear (
+        ruler->store.chunks, old_literals * sizeof *ruler->store.chunks,
+        new_literals * sizeof *ruler->store.chunks);
+
+  simplifier->marks =
+      enlarge_and_clear (simplifier->marks, old_literals, new_literals);
+  simplifier->eliminated = enlarge_and_clear (
+      simplifier->eliminated, old_capacity, new_capacity);
+
+  bva->counts =
+      enlarge_and_clear (bva->counts, old_literals * sizeof *bva->counts,
+                         new_literals * sizeof *bva->counts);
+  bva->stamps =
+      enlarge_and_clear (bva->stamps, old_literals * sizeof *bva->stamps,
+                         new_literals * sizeof *bva->stamps);
+
+  bva->capacity = new_capacity;
+}
+
+static unsigned new_fresh_variable (struct bva *bva) {
+  struct ruler *ruler = bva->simplifier->ruler;
+  if (ruler->compact == bva->capacity)
+    enlarge_variables (bva);
+  assert (ruler->compact < bva->capacity);
+  unsigned idx = ruler->compact++;
+  ruler->fresh++;
+  ruler->eliminate[idx] = false;
+  ruler->subsume[idx] = true;
+  ruler->statistics.active++;
+  ROG ("added fresh %s", ROGVAR (idx));
+  return idx;
+}
+
+/*------------------------------------------------------------------------*/
+
+static unsigned *get_literals (struct clause *clause, unsigned *binary,
+                               unsigned **end_ptr) {
+  if (is_binary_pointer (clause)) {
+    binary[0] = lit_pointer (clause);
+    binary[1] = other_pointer (clause);
+    *end_ptr = binary + 2;
+    return binary;
+  }
+  *end_ptr = clause->literals + clause->size;
+  return clause->literals;
+}
+
+static size_t get_size (struct clause *clause) {
+  return is_binary_pointer (clause) ? 2 : clause->size;
+}
+
+// Marks all literals of the clause except 'lit' and returns the one with
+// the smallest number of occurrences.
+
+static unsigned mark_other_literals (struct bva *bva, unsigned lit,
+                                     struct clause *clause) {
+  struct simplifier *simplifier = bva->simplifier;
+  struct ruler *ruler = simplifier->ruler;
+  signed char *marks = simplifier->marks;
+  unsigned binary[2], *end;
+  unsigned res = INVALID;
+  size_t res_size = 0;
+  for (unsigned *p = get_literals (clause, binary, &end); p != end; p++) {
+    unsigned other = *p;
+    if (other == lit)
+      continue;
+    mark_literal (marks, other);
+    size_t size = SIZE (OCCURRENCES (other));
+    if (res != INVALID && res_size <= size)
+      continue;
+    res = other;
+    res_size = size;
+  }
+  assert (res != INVALID);
+  return res;
+}
+
+static void unmark_other_literals (struct bva *bva, unsigned lit,
+                                   struct clause *clause) {
+  signed char *marks = bva->simplifier->marks;
+  unsigned binary[2], *end;
+  for (unsigned *p = get_literals (clause, binary, &end); p != end; p++)
+    if (*p != lit)
+      unmark_literal (marks, *p);
+}
+
+// Returns the only literal of 'other' which is not marked, provided that
+// 'other' has the given size and all its other literals are marked.
+
+static unsigned replaced_literal (struct bva *bva, struct clause *other,
+                                  size_t size) {
+  if (is_binary_pointer (other)) {
+    if (size != 2)
+      return INVALID;
+  } else {
+    bva->ticks++;
+    if (other->garbage || other->size != size)
+      return INVALID;
+  }
+  signed char *marks = bva->simplifier->marks;
+  unsigned binary[2], *end;
+  unsigned res = INVALID;
+  for (unsigned *p = get_literals (other, binary, &end); p != end; p++) {
+    unsigned lit = *p;
+    signed char mark = marked_literal (marks, lit);
+    if (mark > 0)
+      continue;
+    if (mark < 0 || res != INVALID)
+      return INVALID;
+    res = lit;
+  }
+  return res;
+}
+
+static struct clauses *
+least_occurring_clauses (struct bva *bva, unsigned lit,
+                         struct clause *clause) {
+  struct ruler *ruler = bva->simplifier->ruler;
+  unsigned min_lit = mark_other_literals (bva, lit, clause);
+  struct clauses *res = &OCCURRENCES (min_lit);
+  bva->ticks += 1 + cache_lines (res->end, res->begin);
+  if (SIZE (*res) > ruler->limits.occurrence_limit) {
+    unmark_other_literals (bva, lit, clause);
+    return 0;
+  }
+  return res;
+}
+
+// For each literal 'other' different from 'lit' and 'NOT (lit)' count the
+// clauses 'C' for which 'clause' with 'lit' replaced by 'other' exists.
+
+static void count_replacements (struct bva *bva, unsigned lit,
+                                struct clause *clause) {
+  struct clauses *clauses = least_occurring_clauses (bva, lit, clause);
+  if (!clauses)
+    return;
+  struct ruler *ruler = bva->simplifier->ruler;
+  signed char *values = (signed char *) ruler->values;
+  unsigned not_lit = NOT (lit);
+  size_t size = get_size (clause);
+  unsigned *counts = bva->counts;
+  unsigned *stamps = bva->stamps;
+  if (!++bva->stamp) {
+    memset (stamps, 0, 2 * (size_t) ruler->compact * sizeof *stamps);
+    bva->stamp = 1;
+  }
+  unsigned stamp = bva->stamp;
+  for (all_clauses (other_clause, *clauses)) {
+    unsigned other = replaced_literal (bva, other_clause, size);
+    if (other == INVALID || other == lit || other == not_lit)
+      continue;
+    if (values[other])
+      continue;
+    if (counts[other] == INVALID)
+      continue;
+    if (stamps[other] == stamp)
+      continue;
+    stamps[other] = stamp;
+    if (!counts[other]++)
+      PUSH (bva->touched, other);
+  }
+  unmark_other_literals (bva, lit, clause);
+}
+
+static struct clause *find_replaced_clause (struct bva *bva, unsigned lit,
+                                            struct clause *clause,
+                                            unsigned replacement) {
+  struct clauses *clauses = least_occurring_clauses (bva, lit, clause);
+  if (!clauses)
+    return 0;
+  size_t size = get_size (clause);
+  struct clause *res = 0;
+  for (all_clauses (other_clause, *clauses))
+    if (replaced_literal (bva, other_clause, size) == replacement) {
+      res = other_clause;
+      break;
+    }
+  unmark_other_literals (bva, lit, clause);
+  return res;
+}
+
+static void delete_replaced_clause (struct simplifier *simplifier,
+                                    struct clause *clause, unsigned lit) {
+  struct ruler *ruler = simplifier->ruler;
+  if (is_binary_pointer (clause)) {
+    unsigned other = lit_pointer (clause);
+    if (other == lit)
+      other = other_pointer (clause);
+    clause = tag_binary (false, lit, other);
+    recycle_clause (simplifier, clause, lit);
+    disconnect_literal (ruler, lit, clause);
+  } else
+    recycle_clause (simplifier, clause, lit);
+}
+
+static void replace_clauses (struct bva *bva, unsigned lit) {
+  struct simplifier *simplifier = bva->simplifier;
+  struct ruler *ruler = simplifier->ruler;
+  unsigned idx = new_fresh_variable (bva);
+  unsigned pos = LIT (idx);
+  unsigned neg = NOT (pos);
+  ROG ("replacing %zu x %zu clauses with %zu using %s",
+       SIZE (bva->literals), SIZE (bva->clauses),
+       SIZE (bva->literals) + SIZE (bva->clauses), ROGVAR (idx));
+  struct unsigneds *resolvent = &simplifier->resolvent;
+  for (all_clauses (clause, bva->clauses)) {
+    CLEAR (*resolvent);
+    PUSH (*resolvent, neg);
+    unsigned binary[2], *end;
+    for (unsigned *p = get_literals (clause, binary, &end); p != end; p++)
+      if (*p != lit)
+        PUSH (*resolvent, *p);
+    add_resolvent (simplifier);
+  }
+  for (all_elements_on_stack (unsigned, other, bva->literals)) {
+    CLEAR (*resolvent);
+    PUSH (*resolvent, pos);
+    PUSH (*resolvent, other);
+    add_resolvent (simplifier);
+  }
+  CLEAR (*resolvent);
+  size_t added = SIZE (bva->literals) + SIZE (bva->clauses);
+  size_t replaced = 0;
+  for (all_elements_on_stack (unsigned, other, bva->literals))
+    for (all_clauses (clause, bva->clauses)) {
+      struct clause *replaced_clause = clause;
+      if (other != lit) {
+        replaced_clause = find_replaced_clause (bva, lit, clause, other);
+        if (!replaced_clause)
+          continue;
+      } else if (!is_binary_pointer (clause) && clause->garbage)
+        continue;
+      delete_replaced_clause (simplifier, replaced_clause, other);
+      replaced++;
+    }
+  struct ruler_statistics *statistics = &ruler->statistics;
+  statistics->bva.replaced += replaced;
+  if (replaced > added)
+    statistics->bva.reduced += replaced - added;
+}
+
+static int64_t reduction (size_t literals, size_t clauses) {
+  int64_t l = literals, c = clauses;
+  return l * c - l - c;
+}
+
+static bool factor_literal (struct bva *bva, unsigned lit) {
+  struct ruler *ruler = bva->simplifier->ruler;
+  size_t clause_size_limit = ruler->limits.clause_size_limit;
+  struct clauses *occurrences = &OCCURRENCES (lit);
+  bva->ticks += 1 + cache_lines (occurrences->end, occurrences->begin);
+  signed char *marks = bva->simplifier->marks;
+  CLEAR (bva->clauses);
+  for (all_clauses (clause, *occurrences)) {
+    if (is_binary_pointer (clause)) {
+      unsigned other = other_pointer (clause);
+      if (marked_literal (marks, other))
+        continue;
+      mark_literal (marks, other);
+    } else {
+      bva->ticks++;
+      if (clause->garbage)
+        continue;
+      if (clause->size > clause_size_limit)
+        continue;
+    }
+    PUSH (bva->clauses, clause);
+  }
+  for (all_clauses (clause, bva->clauses))
+    if (is_binary_pointer (clause))
+      unmark_literal (marks, other_pointer (clause));
+  if (SIZE (bva->clauses) < 2)
+    return false;
+  ROG ("trying to factor %zu clauses with %s", SIZE (bva->clauses),
+       ROGLIT (lit));
+
+  unsigned *counts = bva->counts;
+  CLEAR (bva->literals);
+  PUSH (bva->literals, lit);
+  counts[lit] = INVALID;
+  int64_t current = reduction (1, SIZE (bva->clauses));
+
+  while (!bva_ticks_limit_hit (bva)) {
+    for (all_clauses (clause, bva->clauses))
+      count_replacements (bva, lit, clause);
+    unsigned best = INVALID, best_count = 0;
+    for (all_elements_on_stack (unsigned, other, bva->touched)) {
+      unsigned count = counts[other];
+      counts[other] = 0;
+      if (count < best_count)
+        continue;
+      if (count == best_count && other > best)
+        continue;
+      best = other;
+      best_count = count;
+    }
+    CLEAR (bva->touched);
+    if (best == INVALID)
+      break;
+    int64_t next = reduction (SIZE (bva->literals) + 1, best_count);
+    if (next <= current)
+      break;
+    ROG ("adding %s occurring in %u matching clauses", ROGLIT (best),
+         best_count);
+    struct clause **begin = bva->clauses.begin, **q = begin;
+    struct clause **end = bva->clauses.end, **p = q;
+    while (p != end) {
+      struct clause *clause = *p++;
+      if (find_replaced_clause (bva, lit, clause, best))
+        *q++ = clause;
+    }
+    bva->clauses.end = q;
+    assert (SIZE (bva->clauses) == best_count);
+    PUSH (bva->literals, best);
+    counts[best] = INVALID;
+    current = next;
+  }
+
+  for (all_elements_on_stack (unsigned, other, bva->literals))
+    counts[other] = 0;
+
+  if (current <= 0)
+    return false;
+
+  assert (SIZE (bva->literals) > 1);
+  replace_clauses (bva, lit);
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Literals are tried in the order of decreasing number of occurrences,
+// which are sorted by counting sort as in 'get_subsumption_candidates'.
+
+static size_t gather_bva_literals (struct bva *bva, unsigned **literals) {
+  struct simplifier *simplifier = bva->simplifier;
+  struct ruler *ruler = simplifier->ruler;
+  signed char *values = (signed char *) ruler->values;
+  bool *eliminated = simplifier->eliminated;
+  size_t occurrence_limit = ruler->limits.occurrence_limit;
+  size_t max_size = 0;
+  bva->ticks += ruler->compact;
+  for (all_ruler_literals (lit)) {
+    size_t size = SIZE (OCCURRENCES (lit));
+    if (size > occurrence_limit)
+      continue;
+    if (size > max_size)
+      max_size = size;
+  }
+  if (max_size < 2) {
+    *literals = 0;
+    return 0;
+  }
+  size_t *count = allocate_and_clear_array (max_size + 1, sizeof *count);
+  for (all_ruler_literals (lit)) {
+    if (values[lit] || eliminated[IDX (lit)])
+      continue;
+    size_t size = SIZE (OCCURRENCES (lit));
+    if (2 <= size && size <= max_size)
+      count[size]++;
+  }
+  size_t pos = 0;
+  for (size_t size = max_size; size > 1; size--) {
+    size_t tmp = count[size];
+    count[size] = pos;
+    pos += tmp;
+  }
+  unsigned *res = allocate_array (pos, sizeof *res);
+  for (all_ruler_literals (lit)) {
+    if (values[lit] || eliminated[IDX (lit)])
+      continue;
+    size_t size = SIZE (OCCURRENCES (lit));
+    if (2 <= size && size <= max_size)
+      res[count[size]++] = lit;
+  }
+  free (count);
+  *literals = res;
+  return pos;
+}
+
+bool bounded_variable_addition (struct simplifier *simplifier,
+                                unsigned round) {
+  struct ruler *ruler = simplifier->ruler;
+  if (!ruler->options.bva)
+    return false;
+  if (!EMPTY (ruler->rings))
+    return false;
+  if (ruler->options.exchange || ruler->options.listen ||
+      ruler->options.connect)
+    return false;
+  assert (!ruler->unmap);
+#ifndef QUIET
+  double start_bva = START (ruler, bva);
+#endif
+  struct bva bva;
+  memset (&bva, 0, sizeof bva);
+  bva.simplifier = simplifier;
+  bva.capacity = ruler->compact;
+  size_t literals = 2 * (size_t) ruler->compact;
+  bva.counts = allocate_and_clear_array (literals, sizeof *bva.counts);
+  bva.stamps = allocate_and_clear_array (literals, sizeof *bva.stamps);
+
+  unsigned *candidates;
+  size_t size_candidates = gather_bva_literals (&bva, &candidates);
+  verbose (0, "[%u] gathered %zu variable addition candidate literals",
+           round, size_candidates);
+  unsigned fresh = ruler->fresh;
+  uint64_t reduced = ruler->statistics.bva.reduced;
+  size_t tried = 0;
+  while (tried != size_candidates) {
+    if (ruler->terminate)
+      break;
+    if (bva_ticks_limit_hit (&bva))
+      break;
+    if (ruler->compact == MAX_VAR)
+      break;
+    unsigned lit = candidates[tried++];
+    if (ruler->values[lit])
+      continue;
+    (void) factor_literal (&bva, lit);
+    flush_bva_ticks (&bva);
+  }
+  flush_bva_ticks (&bva);
+  fresh = ruler->fresh - fresh;
+  reduced = ruler->statistics.bva.reduced - reduced;
+
+  free (candidates);
+  free (bva.counts);
+  free (bva.stamps);
+  RELEASE (bva.literals);
+  RELEASE (bva.touched);
+  RELEASE (bva.clauses);
+  RELEASE (simplifier->resolvent);
+
+#ifndef QUIET
+  double end_bva = STOP (ruler, bva);
+  message (0,
+           "[%u] added %u variables reducing %" PRIu64 " clauses "
+           "in %.2f seconds",
+           round, fresh, reduced, end_bva - start_bva);
+  if (tried != size_candidates)
+    verbose (0, "[%u] tried %zu candidate literals %.0f%%", round, tried,
+             percent (tried, size_candidates));
+#endif
+  return fresh;
+}
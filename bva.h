@@ -0,0 +1,10 @@
+#ifndef _bva_h_INCLUDED
+#define _bva_h_INCLUDED
+
+#include <stdbool.h>
+
+struct simplifier;
+
+bool bounded_variable_addition (struct simplifier *, unsigned round);
+
+#endif
@@ -2,6 +2,7 @@
 #include "message.h"
 #include "ruler.h"
 #include "statistics.h"
+#include "telemetry.h"
 
 #include <assert.h>
 #include <signal.h>
@@ -18,6 +19,7 @@ static atomic_int caught_signal;
 static volatile struct ruler *one_global_ruler;
 static atomic_bool catching_signals;
 static atomic_bool catching_alarm;
+static atomic_bool catching_telemetry;
 
 /*------------------------------------------------------------------------*/
 
@@ -38,6 +40,7 @@ static void (*saved_ ## SIG ## _handler)(int);
 SIGNALS
 #undef SIGNAL
 static void (*saved_SIGALRM_handler)(int);
+static void (*saved_SIGUSR1_handler)(int);
 
 // clang-format on
 
@@ -46,6 +49,11 @@ static void reset_alarm_handler (void) {
     signal (SIGALRM, saved_SIGALRM_handler);
 }
 
+static void reset_telemetry_handler (void) {
+  if (atomic_exchange (&catching_telemetry, false))
+    signal (SIGUSR1, saved_SIGUSR1_handler);
+}
+
 void reset_signal_handlers (void) {
   one_global_ruler = 0;
   if (atomic_exchange (&catching_signals, false)) {
@@ -57,6 +65,7 @@ void reset_signal_handlers (void) {
     // clang-format on
   }
   reset_alarm_handler ();
+  reset_telemetry_handler ();
 }
 
 static void caught_message (int sig) {
@@ -136,6 +145,20 @@ static void catch_alarm (int sig) {
   caught_signal = 0;
 }
 
+static void catch_telemetry (int sig) {
+  assert (sig == SIGUSR1);
+  (void) sig;
+  struct ruler *ruler = (struct ruler *) one_global_ruler;
+  if (ruler)
+    request_telemetry (ruler);
+}
+
+static void set_telemetry_handler (void) {
+  assert (!catching_telemetry);
+  saved_SIGUSR1_handler = signal (SIGUSR1, catch_telemetry);
+  catching_telemetry = true;
+}
+
 static void set_alarm_handler (unsigned seconds) {
   assert (seconds);
   assert (!catching_alarm);
@@ -157,4 +180,6 @@ void set_signal_handlers (struct ruler *ruler) {
   catching_signals = true;
   if (seconds)
     set_alarm_handler (seconds);
+  if (ruler->options.telemetry)
+    set_telemetry_handler ();
 }
@@ -1,17 +1,21 @@
 #include "clause.h"
+#include "arena.h"
 #include "logging.h"
 #include "ring.h"
+#include "sort.h"
 #include "tagging.h"
 #include "trace.h"
 #include "utilities.h"
 
 #include <string.h>
 
-struct clause *new_large_clause (size_t size, unsigned *literals,
-                                 bool redundant, unsigned glue) {
+struct clause *new_large_clause (struct arena *arena, size_t size,
+                                 unsigned *literals, bool redundant,
+                                 unsigned glue) {
   assert (2 <= size);
   size_t bytes = size * sizeof (unsigned);
-  struct clause *clause = allocate_block (sizeof *clause + bytes);
+  struct clause *clause =
+      allocate_from_arena (arena, sizeof *clause + bytes);
 
 #ifdef LOGGING
   clause->id = atomic_fetch_add (&clause_ids, 1);
@@ -35,10 +39,23 @@ struct clause *new_large_clause (size_t size, unsigned *literals,
   clause->size = size;
 
   memcpy (clause->literals, literals, bytes);
+  update_signature (clause);
 
   return clause;
 }
 
+void update_signature (struct clause *clause) {
+  uint64_t signature = 0;
+  for (all_literals_in_clause (lit, clause))
+    signature |= variable_signature (IDX (lit));
+  clause->signature = signature;
+}
+
+void deallocate_clause (struct arena *arena, struct clause *clause) {
+  assert (!is_binary_pointer (clause));
+  deallocate_to_arena (arena, clause);
+}
+
 void mark_clause (signed char *marks, struct clause *clause,
                   unsigned except) {
   if (is_binary_pointer (clause))
@@ -73,7 +90,7 @@ static void delete_clause (struct ring *ring, struct clause *clause) {
   assert (!is_binary_pointer (clause));
   LOGCLAUSE (clause, "delete");
   trace_delete_clause (&ring->trace, clause);
-  free (clause);
+  deallocate_clause (ring->arena, clause);
 }
 
 void reference_clause (struct ring *ring, struct clause *clause,
@@ -95,3 +112,76 @@ bool dereference_clause (struct ring *ring, struct clause *clause) {
   delete_clause (ring, clause);
   return true;
 }
+
+bool dereference_clause_times (struct ring *ring, struct clause *clause,
+                               unsigned dec) {
+  assert (dec);
+  assert (!is_binary_pointer (clause));
+  unsigned shared = atomic_fetch_sub (&clause->shared, dec);
+  LOGCLAUSE (clause, "dereference %u times (was shared %u)", dec, shared);
+  assert (shared + 1 >= dec);
+  if (shared + 1 != dec)
+    return false;
+  delete_clause (ring, clause);
+  return true;
+}
+
+// Shared clauses which a ring drops without ever having watched them
+// (rejected imports and overwritten or flushed exports) are not
+// dereferenced immediately, since the atomic decrement of 'shared' is a
+// write to the first cache line of the clause, which other rings keep
+// reading during propagation.  Instead they are collected on 'deferred'
+// and reconciled in batches, i.e., sorted such that all deferred
+// dereferences of the same clause (which are frequent for clauses
+// exported to many rings and then overwritten) are applied with one
+// atomic subtraction.  Since the clause is still referenced until then it
+// can not be deleted by another ring in the mean time.
+
+void defer_dereference_clause (struct ring *ring, struct clause *clause) {
+  assert (!is_binary_pointer (clause));
+  unsigned limit = ring->options.defer_dereferences;
+  if (!limit) {
+    dereference_clause (ring, clause);
+    return;
+  }
+  LOGCLAUSE (clause, "deferring dereference of");
+  PUSH (ring->deferred, clause);
+  ring->statistics.deferred.dereferences++;
+  if (SIZE (ring->deferred) >= limit)
+    reconcile_deferred_dereferences (ring);
+}
+
+#define LESS_CLAUSE_POINTER(C, D) ((C) < (D))
+
+void reconcile_deferred_dereferences (struct ring *ring) {
+  struct clauses *deferred = &ring->deferred;
+  size_t size = SIZE (*deferred);
+  if (!size)
+    return;
+  SORT (struct clause *, size, deferred->begin, LESS_CLAUSE_POINTER);
+  struct clause **end = deferred->end;
+  struct clause **p = deferred->begin;
+  while (p != end) {
+    struct clause *clause = *p;
+    struct clause **q = p + 1;
+    while (q != end && *q == clause)
+      q++;
+    dereference_clause_times (ring, clause, q - p);
+    ring->statistics.deferred.reconciled++;
+    p = q;
+  }
+  CLEAR (*deferred);
+  ring->statistics.deferred.batches++;
+}
+
+void release_deferred_dereferences (struct ring *ring) {
+  for (all_clauses (clause, ring->deferred)) {
+    unsigned shared = atomic_fetch_sub (&clause->shared, 1);
+    assert (shared + 1);
+    if (!shared) {
+      LOGCLAUSE (clause, "final delete");
+      deallocate_clause (ring->arena, clause);
+    }
+  }
+  RELEASE (ring->deferred);
+}
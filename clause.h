@@ -3,12 +3,10 @@
 
 #include <stdatomic.h>
 #include <stdbool.h>
-#include <stdlib.h>
-
-#ifdef LOGGING
 #include <stdint.h>
-#endif
+#include <stdlib.h>
 
+struct arena;
 struct ring;
 
 #define MAX_GLUE 255
@@ -17,6 +15,7 @@ struct clause {
 #ifdef LOGGING
   uint64_t id;
 #endif
+  uint64_t signature;
   atomic_uint shared;
   unsigned short origin;
   atomic_uchar glue;
@@ -49,13 +48,38 @@ struct clauses {
 
 /*------------------------------------------------------------------------*/
 
-struct clause *new_large_clause (size_t, unsigned *, bool redundant,
-                                 unsigned glue);
+// The signature of a large clause over-approximates its set of variables
+// by hashing each variable to one of 64 bits.  A clause can only subsume
+// (or strengthen through self-subsuming resolution) another clause if its
+// signature is a subset of the signature of the other clause.  It has to
+// be updated whenever literals of the clause are removed or renumbered.
+
+static inline uint64_t variable_signature (unsigned idx) {
+  return (uint64_t) 1 << ((idx * 0x9e3779b1u) >> 26);
+}
+
+static inline bool subset_signature (uint64_t a, uint64_t b) {
+  return !(a & ~b);
+}
+
+void update_signature (struct clause *);
+
+/*------------------------------------------------------------------------*/
+
+struct clause *new_large_clause (struct arena *, size_t, unsigned *,
+                                 bool redundant, unsigned glue);
+void deallocate_clause (struct arena *, struct clause *);
 
 void mark_clause (signed char *marks, struct clause *, unsigned except);
 void unmark_clause (signed char *marks, struct clause *, unsigned except);
 
 void reference_clause (struct ring *, struct clause *, unsigned inc);
 bool dereference_clause (struct ring *, struct clause *);
+bool dereference_clause_times (struct ring *, struct clause *,
+                               unsigned dec);
+
+void defer_dereference_clause (struct ring *, struct clause *);
+void reconcile_deferred_dereferences (struct ring *);
+void release_deferred_dereferences (struct ring *);
 
 #endif
@@ -87,22 +87,22 @@ static void restore_saved_redundant_clauses (struct ring *ring) {
   for (struct saved_watcher *sw = begin; sw != end; sw++) {
     struct clause *clause = sw->clause;
     if (is_binary_pointer (clause)) {
-      struct watch *lit_watch = (struct watch *) clause;
-      unsigned lit = lit_pointer (clause);
-      push_watch (ring, lit, lit_watch);
       assert (redundant_pointer (clause));
+      unsigned lit = lit_pointer (clause);
       unsigned other = other_pointer (clause);
-      struct watch *other_watch = tag_binary (true, other, lit);
-      push_watch (ring, other, other_watch);
+      push_redundant_binary (ring, lit, other);
+      push_redundant_binary (ring, other, lit);
       binaries++;
     } else {
       assert (!clause->mapped);
       assert (!clause->garbage);
       struct watch *watch =
           watch_first_two_literals_in_large_clause (ring, clause);
-      struct watcher *watcher = get_watcher (ring, watch);
-      watcher->used = sw->used;
-      watcher->vivify = sw->vivify;
+      unsigned idx = index_pointer (watch);
+      struct watcher_usage *usage = index_to_usage (ring, idx);
+      usage->used = sw->used;
+      usage->vivify = sw->vivify;
+      usage->source = sw->source;
 #ifndef QUIET
       large++;
 #endif
@@ -127,7 +127,7 @@ void copy_ruler (struct ring *ring) {
   if (ruler->inconsistent) {
     set_inconsistent (ring, "copied empty clause");
     for (all_clauses (clause, ruler->clauses))
-      free (clause);
+      deallocate_clause (ring->arena, clause);
   } else if (ruler->terminate) {
     return;
   } else {
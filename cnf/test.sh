@@ -36,6 +36,40 @@ run () {
   ron $1 $2 "--no-simplify --threads=4"
 }
 
+two () {
+  name=$2`echo -- "$3 $4"|sed -e 's,[=: ],,g;s,--*,-,g'`
+  cnf=cnf/$2.cnf
+  log=cnf/$name.log
+  err=cnf/$name.err
+  first_log=cnf/$name-first.log
+  first_err=cnf/$name-first.err
+  rm -f $log $err $first_log $first_err
+  first="./gimsatul $cnf $3"
+  cmd="./gimsatul $cnf $4"
+  echo "$first & $cmd"
+  $first 1>$first_log 2>$first_err &
+  pid=$!
+  $cmd 1>$log 2>$err
+  status=$?
+  wait $pid
+  first_status=$?
+  if [ ! $1 = $first_status ]
+  then
+    echo "cnf/test.sh: error: '$first' exits with status '$first_status' but expected '$1'"
+    exit 1
+  fi
+  if [ ! $1 = $status ]
+  then
+    echo "cnf/test.sh: error: '$cmd' exits with status '$status' but expected '$1'"
+    exit 1
+  fi
+  if ! grep -q "$5" $log
+  then
+    echo "cnf/test.sh: error: '$cmd' does not print '$5'"
+    exit 1
+  fi
+}
+
 run 20 false
 run 10 true
 
@@ -104,3 +138,28 @@ run 10 sqrt16129
 run 10 sqrt63001
 run 10 sqrt259081
 run 10 sqrt1042441
+
+ron 20 add64 "--prefetch=8"
+ron 20 add64 "--prefetch=8 --threads=4"
+ron 10 sqrt10201 "--prefetch=3 --threads=2"
+ron 20 prime65537 "--trail-saving=1"
+ron 20 add64 "--trail-saving=1 --threads=4"
+ron 10 sqrt10201 "--trail-saving=1 --threads=2"
+ron 20 add64 "--pool-capacity=2 --threads=4"
+ron 20 add64 "--import-batch=100 --threads=4"
+ron 20 add64 "--import-feedback=1 --threads=4"
+ron 20 add64 "--export-filter=4 --threads=4"
+ron 20 add64 "--export=4 --pin=1 --threads=4"
+ron 10 sqrt10201 "--exchange=gimsatul-test --threads=2"
+two 20 prime4294967297 "--exchange=gimsatul-test" "--exchange=gimsatul-test --threads=2" "exchange-imported: *[1-9]"
+ron 10 sqrt10201 "--connect=localhost:1 --threads=2"
+two 20 prime4294967297 "--listen=43917" "--connect=localhost:43917 --threads=2" "network-received: *[1-9]"
+ron 20 add64 "--defer-dereferences=1 --threads=4"
+ron 20 add64 "--binary-store=1 --threads=4"
+ron 20 add64 "--eliminate-threads=1 --threads=4"
+ron 20 add64 "--subsume-threads=1 --threads=4"
+ron 20 ph6 "--bva=1"
+ron 20 add64 "--bva=1 --threads=2"
+ron 10 sqrt10201 "--bva=1"
+ron 20 add64 "--xor-arity=4"
+ron 10 sqrt10201 "--xor-arity=4 --threads=2"
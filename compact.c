@@ -1,4 +1,5 @@
 #include "compact.h"
+#include "exchange.h"
 #include "message.h"
 #include "ruler.h"
 #include "simplify.h"
@@ -49,6 +50,7 @@ static void map_large_clause (unsigned *map, struct clause *clause) {
   unsigned *end = literals + clause->size;
   for (unsigned *p = literals; p != end; p++)
     *p = map_literal (map, *p);
+  update_signature (clause);
 }
 
 static void map_clauses (struct ruler *ruler, unsigned *map) {
@@ -149,6 +151,7 @@ static void clean_ring (struct ring *ring, struct clauses *cleaned) {
           memcpy (clause->literals, add.begin,
                   new_size * sizeof (unsigned));
           clause->size = new_size;
+          update_signature (clause);
           LOGCLAUSE (clause, "cleaned");
           clause->cleaned = true;
           PUSH (*cleaned, clause);
@@ -329,6 +332,7 @@ static void compact_saved (struct ring *ring, unsigned *map,
           LOGSUFFIX ();
         }
 #endif
+        update_signature (dst_clause);
         dst_clause->mapped = true;
         PUSH (*mapped, dst_clause);
         *q++ = src_watcher;
@@ -517,9 +521,11 @@ void compact_ruler (struct simplifier *simplifier, bool initially) {
   free (ruler->units.begin);
   ruler->units.begin = allocate_array (new_compact, sizeof (unsigned));
   ruler->units.propagate = ruler->units.end = ruler->units.begin;
+  ruler->units.reserved = 0;
 
   if (!initially)
     compact_rings (ruler, map);
+  compact_store (ruler, map);
 
   free (map);
   if (old_unmap)
@@ -529,9 +535,11 @@ void compact_ruler (struct simplifier *simplifier, bool initially) {
   ruler->trace.unmap = unmap;
   for (all_rings (ring))
     ring->trace.unmap = unmap;
+  map_exchange (ruler);
 
   free ((void *) ruler->values);
   ruler->values = allocate_and_clear_block (2 * new_compact);
+  clear_filter (ruler);
 
   verbose (0, "mapped %u variables to %u variables", ruler->size, mapped);
 }
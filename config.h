@@ -0,0 +1,4 @@
+#define COMPILER "gcc (Debian 12.2.0-14+deb12u1) 12.2.0 -Wall -O3 -DNDEBUG"
+#define GITID "ecf6c46b64400dd8f0ecb753f8a25a064f371f02"
+#define VERSION "1.1.3"
+#define BUILD "Fri Oct 16 11:26:51 UTC 2026 Linux vm 6.18.44-fc-v130 x86_64"
@@ -3,6 +3,8 @@
 #include "ruler.h"
 #include "simplify.h"
 
+#include <string.h>
+
 static bool find_binary_and_gate_clauses (struct simplifier *simplifier,
                                           unsigned lit,
                                           struct clause *clause,
@@ -77,6 +79,223 @@ static unsigned find_equivalence_gate (struct simplifier *simplifier,
   return res;
 }
 
+// Splits the occurrences of 'lit' into the given gate clauses and the
+// remaining non-gate clauses.
+
+static void split_occurrences (struct simplifier *simplifier, unsigned lit,
+                               struct clause *first, struct clause *second,
+                               struct clauses *gate,
+                               struct clauses *nogate) {
+  struct ruler *ruler = simplifier->ruler;
+  CLEAR (*gate);
+  CLEAR (*nogate);
+  PUSH (*gate, first);
+  PUSH (*gate, second);
+  for (all_clauses (clause, OCCURRENCES (lit)))
+    if (clause != first && clause != second)
+      PUSH (*nogate, clause);
+}
+
+static struct clause *find_ternary_clause (struct simplifier *simplifier,
+                                           unsigned lit, unsigned other,
+                                           unsigned third) {
+  struct ruler *ruler = simplifier->ruler;
+  for (all_clauses (clause, OCCURRENCES (lit))) {
+    if (is_binary_pointer (clause))
+      continue;
+    simplifier->ticks++;
+    if (clause->size != 3)
+      continue;
+    assert (!clause->garbage);
+    unsigned found = 0;
+    for (all_literals_in_clause (tmp, clause))
+      if (tmp == other || tmp == third)
+        found++;
+    if (found == 2)
+      return clause;
+  }
+  return 0;
+}
+
+// The gate 'lit = cond ? then : else' is encoded by the four clauses
+//
+//   (-lit | -cond | then), (-lit | cond | else),
+//   ( lit | -cond | -then), ( lit | cond | -else)
+//
+// where the first two are found in the occurrences of 'NOT (lit)' and the
+// last two in those of 'lit'.  This encoding is invariant under negating
+// 'lit', 'then' and 'else', and thus we only need to search for 'lit'.
+// Degenerated gates with 'then' and 'else' on the same variable are
+// equivalences or XOR gates and left to the other procedures.
+
+static bool find_ite_gate (struct simplifier *simplifier, unsigned lit) {
+  struct ruler *ruler = simplifier->ruler;
+  struct clauses *gate = simplifier->gate;
+  struct clauses *nogate = simplifier->nogate;
+  unsigned not_lit = NOT (lit);
+  struct clauses *not_lit_clauses = &OCCURRENCES (not_lit);
+  for (all_clauses (first, *not_lit_clauses)) {
+    if (is_binary_pointer (first))
+      continue;
+    simplifier->ticks++;
+    if (first->size != 3)
+      continue;
+    assert (!first->garbage);
+    unsigned others[2], size_others = 0;
+    for (all_literals_in_clause (other, first))
+      if (other != not_lit)
+        others[size_others++] = other;
+    assert (size_others == 2);
+    for (unsigned i = 0; i != 2; i++) {
+      unsigned not_cond = others[i];
+      unsigned then_lit = others[!i];
+      unsigned cond = NOT (not_cond);
+      unsigned not_then = NOT (then_lit);
+      struct clause *third =
+          find_ternary_clause (simplifier, lit, not_cond, not_then);
+      if (!third)
+        continue;
+      for (all_clauses (second, *not_lit_clauses)) {
+        if (is_binary_pointer (second) || second == first)
+          continue;
+        simplifier->ticks++;
+        if (second->size != 3)
+          continue;
+        unsigned else_lit = INVALID;
+        bool contains_cond = false;
+        for (all_literals_in_clause (other, second))
+          if (other == cond)
+            contains_cond = true;
+          else if (other != not_lit)
+            else_lit = other;
+        if (!contains_cond)
+          continue;
+        assert (else_lit != INVALID);
+        if (IDX (else_lit) == IDX (then_lit))
+          continue;
+        unsigned not_else = NOT (else_lit);
+        struct clause *fourth =
+            find_ternary_clause (simplifier, lit, cond, not_else);
+        if (!fourth)
+          continue;
+        ROG ("found ite-gate with %s defined as %s ? %s : %s",
+             ROGLIT (lit), ROGLIT (cond), ROGLIT (then_lit),
+             ROGLIT (else_lit));
+        split_occurrences (simplifier, lit, third, fourth, &gate[0],
+                           &nogate[0]);
+        split_occurrences (simplifier, not_lit, first, second, &gate[1],
+                           &nogate[1]);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// The clauses of a XOR gate of arity 'k' with base clause 'C' (containing
+// 'lit' or 'NOT (lit)') are all '2^k' clauses over the same variables with
+// an even number of literals of 'C' negated.  The literals of 'C' are
+// marked with their (signed) position in 'C' and each clause of the same
+// size is mapped to the bit-mask of the negated positions, which are
+// then used to detect and skip duplicates.
+
+#define MAX_XOR_SIZE 9
+
+static bool find_xor_gate_clauses (struct simplifier *simplifier,
+                                   unsigned lit, struct clause *base) {
+  struct ruler *ruler = simplifier->ruler;
+  signed char *marks = simplifier->marks;
+  unsigned size = base->size;
+  assert (size <= MAX_XOR_SIZE);
+  signed char position = 0;
+  for (all_literals_in_clause (other, base)) {
+    position++;
+    marks[other] = position;
+    marks[NOT (other)] = -position;
+  }
+  uint64_t seen[(1u << MAX_XOR_SIZE) / 64];
+  memset (seen, 0, sizeof seen);
+  struct clauses *gate = simplifier->gate;
+  struct clauses *nogate = simplifier->nogate;
+  unsigned found = 0;
+  for (unsigned i = 0; i != 2; i++) {
+    unsigned resolve = i ? NOT (lit) : lit;
+    CLEAR (gate[i]);
+    CLEAR (nogate[i]);
+    for (all_clauses (clause, OCCURRENCES (resolve))) {
+      bool matched = false;
+      if (!is_binary_pointer (clause) && clause->size == size) {
+        simplifier->ticks++;
+        unsigned mask = 0, parity = 0;
+        matched = true;
+        for (all_literals_in_clause (other, clause)) {
+          signed char mark = marks[other];
+          if (!mark) {
+            matched = false;
+            break;
+          }
+          if (mark > 0)
+            continue;
+          mask |= 1u << (-mark - 1);
+          parity ^= 1;
+        }
+        if (matched && parity)
+          matched = false;
+        if (matched) {
+          uint64_t bit = (uint64_t) 1 << (mask & 63);
+          uint64_t *word = seen + (mask >> 6);
+          if (*word & bit)
+            matched = false;
+          else
+            *word |= bit;
+        }
+      }
+      if (matched) {
+        PUSH (gate[i], clause);
+        found++;
+      } else
+        PUSH (nogate[i], clause);
+    }
+  }
+  for (all_literals_in_clause (other, base)) {
+    marks[other] = 0;
+    marks[NOT (other)] = 0;
+  }
+  return found == 1u << (size - 1);
+}
+
+static bool find_xor_gate (struct simplifier *simplifier, unsigned lit) {
+  struct ruler *ruler = simplifier->ruler;
+  unsigned max_size = ruler->options.xor_arity + 1;
+  if (max_size < 3)
+    return false;
+  if (max_size > MAX_XOR_SIZE)
+    max_size = MAX_XOR_SIZE;
+  size_t clause_size_limit = ruler->limits.clause_size_limit;
+  if (max_size > clause_size_limit)
+    max_size = clause_size_limit;
+  struct clauses *lit_clauses = &OCCURRENCES (lit);
+  size_t lit_size = SIZE (*lit_clauses);
+  size_t not_lit_size = SIZE (OCCURRENCES (NOT (lit)));
+  for (all_clauses (base, *lit_clauses)) {
+    if (is_binary_pointer (base))
+      continue;
+    simplifier->ticks++;
+    unsigned size = base->size;
+    if (size > max_size)
+      continue;
+    assert (!base->garbage);
+    size_t needed = (size_t) 1 << (size - 2);
+    if (lit_size < needed || not_lit_size < needed)
+      continue;
+    if (find_xor_gate_clauses (simplifier, lit, base)) {
+      ROG ("found %u-ary xor-gate with %s", size - 1, ROGLIT (lit));
+      return true;
+    }
+  }
+  return false;
+}
+
 bool find_definition (struct simplifier *simplifier, unsigned lit) {
   struct ruler *ruler = simplifier->ruler;
   struct clauses *gate = simplifier->gate;
@@ -142,7 +361,8 @@ bool find_definition (struct simplifier *simplifier, unsigned lit) {
     }
   }
   if (!base)
-    return false;
+    return find_ite_gate (simplifier, lit) ||
+           find_xor_gate (simplifier, lit);
 #ifdef LOGGING
   do {
     ROGPREFIX ("found %u-ary and-gate with %s defined as ", base->size - 1,
@@ -8,6 +8,8 @@
 #include "utilities.h"
 
 #include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <string.h>
 
 static size_t actual_occurrences (struct ruler *ruler,
@@ -52,7 +54,7 @@ static bool can_resolve_clause (struct simplifier *simplifier,
   } else {
     assert (!clause->garbage);
     assert (clause->size <= ruler->limits.clause_size_limit);
-    ruler->statistics.ticks.elimination++;
+    simplifier->ticks++;
     for (all_literals_in_clause (lit, clause)) {
       if (lit == except)
         continue;
@@ -82,51 +84,36 @@ static bool is_elimination_candidate (struct simplifier *simplifier,
   if (ruler->values[pivot])
     return false;
 
-  return true;
-}
+  // Fresh variables added by 'bva.c' would just be eliminated again.
 
-static bool can_eliminate_variable (struct simplifier *simplifier,
-                                    unsigned idx) {
-  if (!is_elimination_candidate (simplifier, idx))
+  unsigned *unmap = ruler->unmap;
+  if ((unmap ? unmap[idx] : idx) >= ruler->size)
     return false;
 
+  return true;
+}
+
+static void flush_elimination_ticks (struct simplifier *simplifier) {
   struct ruler *ruler = simplifier->ruler;
-  ROG ("trying next elimination candidate %s", ROGVAR (idx));
-  ruler->eliminate[idx] = false;
+  ruler->statistics.ticks.elimination += simplifier->ticks;
+  simplifier->ticks = 0;
+}
 
-  size_t occurrence_limit = ruler->limits.occurrence_limit;
+// Counts the non-tautological resolvents on 'idx' and checks that they do
+// not exceed the number of occurrences plus the current bound.  This part
+// only reads the formula and thus is also run concurrently for candidates
+// with disjoint neighbourhoods (see 'eliminate_candidates_in_parallel').
+// Ticks are accumulated in the simplifier and flushed by the caller.
 
+static bool resolvents_within_bound (struct simplifier *simplifier,
+                                     unsigned idx, size_t pos_size,
+                                     size_t neg_size) {
+  struct ruler *ruler = simplifier->ruler;
   unsigned pivot = LIT (idx);
-  struct clauses *pos_clauses = &OCCURRENCES (pivot);
-  ROG ("flushing garbage clauses of %s", ROGLIT (pivot));
-  size_t pos_size = actual_occurrences (ruler, pos_clauses);
-
   unsigned not_pivot = NOT (pivot);
+  struct clauses *pos_clauses = &OCCURRENCES (pivot);
   struct clauses *neg_clauses = &OCCURRENCES (not_pivot);
-  ROG ("flushing garbage clauses of %s", ROGLIT (not_pivot));
-  size_t neg_size = actual_occurrences (ruler, neg_clauses);
-
-  if (!pos_size) {
-    ROG ("pure pivot literal %s", ROGLIT (pivot));
-    CLEAR (*simplifier->gate);
-    return true;
-  }
-
-  if (!neg_size) {
-    ROG ("pure negated pivot literal %s", ROGLIT (not_pivot));
-    CLEAR (*simplifier->gate);
-    return true;
-  }
-
   size_t occurrences = pos_size + neg_size;
-  ROG ("candidate %s has %zu = %zu + %zu occurrences", ROGVAR (idx),
-       occurrences, pos_size, neg_size);
-
-  if (pos_size && neg_size && occurrences > occurrence_limit) {
-    ROG ("negative pivot literal %s occurs %zu times (limit %zu)",
-         ROGLIT (not_pivot), neg_size, occurrence_limit);
-    return false;
-  }
 
   size_t resolvents = 0;
   unsigned bound = ruler->limits.current_bound;
@@ -135,7 +122,7 @@ static bool can_eliminate_variable (struct simplifier *simplifier,
        bound);
 
 #ifdef LOGGING
-  uint64_t ticks_before = ruler->statistics.ticks.elimination;
+  uint64_t ticks_before = simplifier->ticks;
   size_t resolutions = 0;
 #endif
 
@@ -145,7 +132,7 @@ static bool can_eliminate_variable (struct simplifier *simplifier,
 
     for (unsigned i = 0; i != 2; i++) {
       for (all_clauses (pos_clause, gate[i])) {
-        ruler->statistics.ticks.elimination++;
+        simplifier->ticks++;
         mark_clause (simplifier->marks, pos_clause, pivot);
         for (all_clauses (neg_clause, nogate[!i])) {
           if (elimination_ticks_limit_hit (simplifier))
@@ -169,7 +156,7 @@ static bool can_eliminate_variable (struct simplifier *simplifier,
     }
   } else {
     for (all_clauses (pos_clause, *pos_clauses)) {
-      ruler->statistics.ticks.elimination++;
+      simplifier->ticks++;
       mark_clause (simplifier->marks, pos_clause, pivot);
       for (all_clauses (neg_clause, *neg_clauses)) {
         if (elimination_ticks_limit_hit (simplifier))
@@ -190,10 +177,9 @@ static bool can_eliminate_variable (struct simplifier *simplifier,
   }
 
   ROG ("candidate %s has %zu = %zu + %zu occurrences "
-       "took %zu resolutions %" PRIu64 " ticks total %" PRIu64,
+       "took %zu resolutions %" PRIu64 " ticks",
        ROGLIT (pivot), limit, pos_size, neg_size, resolutions,
-       ruler->statistics.ticks.elimination - ticks_before,
-       ruler->statistics.ticks.elimination);
+       simplifier->ticks - ticks_before);
 
   if (elimination_ticks_limit_hit (simplifier))
     return false;
@@ -209,6 +195,54 @@ static bool can_eliminate_variable (struct simplifier *simplifier,
   return resolvents <= limit;
 }
 
+static bool can_eliminate_variable (struct simplifier *simplifier,
+                                    unsigned idx) {
+  if (!is_elimination_candidate (simplifier, idx))
+    return false;
+
+  struct ruler *ruler = simplifier->ruler;
+  ROG ("trying next elimination candidate %s", ROGVAR (idx));
+  ruler->eliminate[idx] = false;
+
+  size_t occurrence_limit = ruler->limits.occurrence_limit;
+
+  unsigned pivot = LIT (idx);
+  struct clauses *pos_clauses = &OCCURRENCES (pivot);
+  ROG ("flushing garbage clauses of %s", ROGLIT (pivot));
+  size_t pos_size = actual_occurrences (ruler, pos_clauses);
+
+  unsigned not_pivot = NOT (pivot);
+  struct clauses *neg_clauses = &OCCURRENCES (not_pivot);
+  ROG ("flushing garbage clauses of %s", ROGLIT (not_pivot));
+  size_t neg_size = actual_occurrences (ruler, neg_clauses);
+
+  if (!pos_size) {
+    ROG ("pure pivot literal %s", ROGLIT (pivot));
+    CLEAR (*simplifier->gate);
+    return true;
+  }
+
+  if (!neg_size) {
+    ROG ("pure negated pivot literal %s", ROGLIT (not_pivot));
+    CLEAR (*simplifier->gate);
+    return true;
+  }
+
+  size_t occurrences = pos_size + neg_size;
+  ROG ("candidate %s has %zu = %zu + %zu occurrences", ROGVAR (idx),
+       occurrences, pos_size, neg_size);
+
+  if (pos_size && neg_size && occurrences > occurrence_limit) {
+    ROG ("negative pivot literal %s occurs %zu times (limit %zu)",
+         ROGLIT (not_pivot), neg_size, occurrence_limit);
+    return false;
+  }
+
+  bool res = resolvents_within_bound (simplifier, idx, pos_size, neg_size);
+  flush_elimination_ticks (simplifier);
+  return res;
+}
+
 static bool add_first_antecedent_literals (struct simplifier *simplifier,
                                            struct clause *clause,
                                            unsigned pivot) {
@@ -430,6 +464,340 @@ static void gather_elimination_candidates (struct simplifier *simplifier,
       PUSH (*candidates, idx);
 }
 
+/*------------------------------------------------------------------------*/
+
+// With more than one elimination thread candidates are processed in
+// batches.  A batch is scheduled sequentially by popping candidates in the
+// same order as without threads and only keeping those whose neighbourhood
+// (all variables occurring in clauses together with the candidate) is
+// disjoint from the neighbourhoods of the candidates already in the batch.
+// Overlapping candidates are pushed back to be tried in a later batch.
+// Then the resolvents of the scheduled candidates are counted concurrently
+// (which only reads the formula).  Finally the candidates which turned out
+// to be eliminable are eliminated sequentially in schedule order.  Since
+// the neighbourhoods are disjoint, eliminating one candidate does not
+// change the occurrence lists (nor values) seen by the other candidates of
+// the same batch.  The resulting formula, extension stack and proof trace
+// only depend on the schedule, which is independent of the number of
+// threads (and of the operating system scheduler).  The worker threads
+// are started once per elimination round and then wait for the next
+// batch on a condition variable.
+
+#define MAX_SCHEDULED_CANDIDATES 256
+#define MAX_SCANNED_CANDIDATES 1024
+
+struct candidate {
+  unsigned idx;
+  bool eliminate;
+  size_t pos_size, neg_size;
+  uint64_t ticks;
+};
+
+struct candidates {
+  struct candidate *begin, *end, *allocated;
+};
+
+struct batch {
+  struct candidates scheduled;
+  atomic_size_t next;
+  unsigned *stamps;
+  unsigned stamp;
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+  unsigned started;
+  unsigned running;
+  bool stop;
+};
+
+struct worker {
+  struct simplifier simplifier;
+  struct batch *batch;
+};
+
+static bool stamped_neighbourhood (struct ruler *ruler, unsigned *stamps,
+                                   unsigned stamp, unsigned idx) {
+  if (stamps[idx] == stamp)
+    return true;
+  uint64_t ticks = 0;
+  bool res = false;
+  unsigned pivot = LIT (idx);
+  for (unsigned sign = 0; !res && sign != 2; sign++) {
+    unsigned lit = pivot ^ sign;
+    struct clauses *clauses = &OCCURRENCES (lit);
+    ticks += 1 + cache_lines (clauses->end, clauses->begin);
+    for (all_clauses (clause, *clauses)) {
+      if (is_binary_pointer (clause)) {
+        unsigned other = other_pointer (clause);
+        if (stamps[IDX (other)] == stamp) {
+          res = true;
+          break;
+        }
+      } else if (!clause->garbage) {
+        ticks++;
+        for (all_literals_in_clause (other, clause))
+          if (stamps[IDX (other)] == stamp) {
+            res = true;
+            break;
+          }
+        if (res)
+          break;
+      }
+    }
+  }
+  ruler->statistics.ticks.elimination += ticks;
+  return res;
+}
+
+static void stamp_neighbourhood (struct ruler *ruler, unsigned *stamps,
+                                 unsigned stamp, unsigned idx) {
+  stamps[idx] = stamp;
+  unsigned pivot = LIT (idx);
+  for (unsigned sign = 0; sign != 2; sign++) {
+    unsigned lit = pivot ^ sign;
+    for (all_clauses (clause, OCCURRENCES (lit)))
+      if (is_binary_pointer (clause))
+        stamps[IDX (other_pointer (clause))] = stamp;
+      else
+        for (all_literals_in_clause (other, clause))
+          stamps[IDX (other)] = stamp;
+  }
+}
+
+static void schedule_candidates (struct simplifier *simplifier,
+                                 struct unsigneds *candidates,
+                                 struct batch *batch) {
+  struct ruler *ruler = simplifier->ruler;
+  size_t occurrence_limit = ruler->limits.occurrence_limit;
+  unsigned *stamps = batch->stamps;
+  unsigned stamp = ++batch->stamp;
+  CLEAR (batch->scheduled);
+  atomic_store_explicit (&batch->next, 0, memory_order_relaxed);
+  struct unsigneds deferred;
+  INIT (deferred);
+  size_t scanned = 0;
+  while (!EMPTY (*candidates) &&
+         SIZE (batch->scheduled) < MAX_SCHEDULED_CANDIDATES &&
+         scanned++ < MAX_SCANNED_CANDIDATES) {
+    unsigned idx = POP (*candidates);
+    if (!is_elimination_candidate (simplifier, idx))
+      continue;
+    if (stamped_neighbourhood (ruler, stamps, stamp, idx)) {
+      ROG ("deferring elimination candidate %s", ROGVAR (idx));
+      PUSH (deferred, idx);
+      continue;
+    }
+    ROG ("scheduling elimination candidate %s", ROGVAR (idx));
+    ruler->eliminate[idx] = false;
+    unsigned pivot = LIT (idx);
+    unsigned not_pivot = NOT (pivot);
+    size_t pos_size = actual_occurrences (ruler, &OCCURRENCES (pivot));
+    size_t neg_size = actual_occurrences (ruler, &OCCURRENCES (not_pivot));
+    bool pure = !pos_size || !neg_size;
+    if (!pure && pos_size + neg_size > occurrence_limit) {
+      ROG ("candidate %s occurs %zu times (limit %zu)", ROGVAR (idx),
+           pos_size + neg_size, occurrence_limit);
+      continue;
+    }
+    stamp_neighbourhood (ruler, stamps, stamp, idx);
+    struct candidate candidate = {idx, pure, pos_size, neg_size, 0};
+    PUSH (batch->scheduled, candidate);
+  }
+  while (!EMPTY (deferred))
+    PUSH (*candidates, POP (deferred));
+  RELEASE (deferred);
+}
+
+static void count_resolvents (struct worker *worker) {
+  struct simplifier *simplifier = &worker->simplifier;
+  struct batch *batch = worker->batch;
+  struct candidate *begin = batch->scheduled.begin;
+  size_t size = SIZE (batch->scheduled);
+  for (;;) {
+    size_t i = atomic_fetch_add_explicit (&batch->next, 1,
+                                          memory_order_relaxed);
+    if (i >= size)
+      break;
+    struct candidate *candidate = begin + i;
+    if (candidate->eliminate)
+      continue;
+    assert (!simplifier->ticks);
+    candidate->eliminate =
+        resolvents_within_bound (simplifier, candidate->idx,
+                                 candidate->pos_size, candidate->neg_size);
+    candidate->ticks = simplifier->ticks;
+    simplifier->ticks = 0;
+  }
+}
+
+static void lock_batch (struct batch *batch) {
+  if (pthread_mutex_lock (&batch->mutex))
+    fatal_error ("failed to acquire elimination batch lock");
+}
+
+static void unlock_batch (struct batch *batch) {
+  if (pthread_mutex_unlock (&batch->mutex))
+    fatal_error ("failed to release elimination batch lock");
+}
+
+static void *count_resolvents_of_batches (void *ptr) {
+  struct worker *worker = ptr;
+  struct batch *batch = worker->batch;
+  unsigned started = 0;
+  for (;;) {
+    lock_batch (batch);
+    while (!batch->stop && batch->started == started)
+      pthread_cond_wait (&batch->condition, &batch->mutex);
+    bool stop = batch->stop;
+    started = batch->started;
+    unlock_batch (batch);
+    if (stop)
+      break;
+    count_resolvents (worker);
+    lock_batch (batch);
+    assert (batch->running);
+    if (!--batch->running)
+      pthread_cond_broadcast (&batch->condition);
+    unlock_batch (batch);
+  }
+  return 0;
+}
+
+static void start_elimination_threads (struct worker *workers,
+                                       pthread_t *threads, unsigned size) {
+  struct batch *batch = workers->batch;
+  pthread_mutex_init (&batch->mutex, 0);
+  pthread_cond_init (&batch->condition, 0);
+  for (unsigned i = 1; i < size; i++)
+    if (pthread_create (threads + i, 0, count_resolvents_of_batches,
+                        workers + i))
+      fatal_error ("failed to create elimination thread %u", i);
+}
+
+static void count_resolvents_in_parallel (struct worker *workers,
+                                          unsigned size) {
+  struct batch *batch = workers->batch;
+  lock_batch (batch);
+  assert (!batch->running);
+  batch->running = size - 1;
+  batch->started++;
+  pthread_cond_broadcast (&batch->condition);
+  unlock_batch (batch);
+  count_resolvents (workers);
+  lock_batch (batch);
+  while (batch->running)
+    pthread_cond_wait (&batch->condition, &batch->mutex);
+  unlock_batch (batch);
+}
+
+static void stop_elimination_threads (struct worker *workers,
+                                      pthread_t *threads, unsigned size) {
+  struct batch *batch = workers->batch;
+  lock_batch (batch);
+  batch->stop = true;
+  pthread_cond_broadcast (&batch->condition);
+  unlock_batch (batch);
+  for (unsigned i = 1; i < size; i++)
+    if (pthread_join (threads[i], 0))
+      fatal_error ("failed to join elimination thread %u", i);
+  pthread_cond_destroy (&batch->condition);
+  pthread_mutex_destroy (&batch->mutex);
+}
+
+static unsigned eliminate_scheduled (struct simplifier *simplifier,
+                                     struct batch *batch) {
+  struct ruler *ruler = simplifier->ruler;
+  unsigned eliminated = 0;
+  for (all_elements_on_stack (struct candidate, candidate,
+                              batch->scheduled)) {
+    if (ruler->inconsistent)
+      break;
+    ruler->statistics.ticks.elimination += candidate.ticks;
+    if (!candidate.eliminate)
+      continue;
+    unsigned pivot = LIT (candidate.idx);
+    if (!candidate.pos_size || !candidate.neg_size ||
+        !find_definition (simplifier, pivot))
+      CLEAR (*simplifier->gate);
+    flush_elimination_ticks (simplifier);
+    eliminate_variable (simplifier, candidate.idx);
+    eliminated++;
+  }
+  return eliminated;
+}
+
+static unsigned
+eliminate_candidates_in_parallel (struct simplifier *simplifier,
+                                  struct unsigneds *candidates,
+                                  unsigned threads, unsigned round) {
+  struct ruler *ruler = simplifier->ruler;
+  struct batch batch;
+  memset (&batch, 0, sizeof batch);
+  batch.stamps =
+      allocate_and_clear_array (ruler->compact, sizeof *batch.stamps);
+  struct worker *workers = allocate_array (threads, sizeof *workers);
+  pthread_t *handles = allocate_array (threads, sizeof *handles);
+  for (unsigned i = 0; i != threads; i++) {
+    struct worker *worker = workers + i;
+    worker->batch = &batch;
+    if (i) {
+      memset (&worker->simplifier, 0, sizeof worker->simplifier);
+      worker->simplifier.ruler = ruler;
+      worker->simplifier.eliminated = simplifier->eliminated;
+      worker->simplifier.marks =
+          allocate_and_clear_block (2 * ruler->compact);
+    }
+  }
+  start_elimination_threads (workers, handles, threads);
+  unsigned eliminated = 0;
+#ifndef QUIET
+  unsigned batches = 0, max_scheduled = 0;
+#endif
+  while (!EMPTY (*candidates)) {
+    if (ruler->inconsistent)
+      break;
+    if (ruler->terminate)
+      break;
+    if (elimination_ticks_limit_hit (simplifier))
+      break;
+    schedule_candidates (simplifier, candidates, &batch);
+    unsigned scheduled = SIZE (batch.scheduled);
+    if (!scheduled)
+      continue;
+#ifndef QUIET
+    batches++;
+    if (scheduled > max_scheduled)
+      max_scheduled = scheduled;
+#endif
+    workers[0].simplifier = *simplifier;
+    count_resolvents_in_parallel (workers, threads);
+    *simplifier = workers[0].simplifier;
+    eliminated += eliminate_scheduled (simplifier, &batch);
+  }
+  stop_elimination_threads (workers, handles, threads);
+  for (unsigned i = 1; i < threads; i++) {
+    struct simplifier *other = &workers[i].simplifier;
+    free (other->marks);
+    RELEASE (other->gate[0]);
+    RELEASE (other->gate[1]);
+    RELEASE (other->nogate[0]);
+    RELEASE (other->nogate[1]);
+  }
+  free (handles);
+  free (workers);
+  free (batch.stamps);
+  RELEASE (batch.scheduled);
+  verbose (0,
+           "[%u] eliminated %u variables in %u batches "
+           "of at most %u candidates with %u threads",
+           round, eliminated, batches, max_scheduled, threads);
+  return eliminated;
+}
+
+static unsigned elimination_threads (struct ruler *ruler) {
+  struct options *options = &ruler->options;
+  return MIN (options->threads, options->eliminate_threads);
+}
+
 bool eliminate_variables (struct simplifier *simplifier, unsigned round) {
   struct ruler *ruler = simplifier->ruler;
   if (!ruler->options.eliminate)
@@ -452,21 +820,25 @@ bool eliminate_variables (struct simplifier *simplifier, unsigned round) {
            scheduled, percent (scheduled, variables));
 #endif
   unsigned eliminated = 0;
+  unsigned threads = elimination_threads (ruler);
 
-  while (!EMPTY (candidates)) {
-    if (ruler->inconsistent)
-      break;
-    if (ruler->terminate)
-      break;
-    if (elimination_ticks_limit_hit (simplifier))
-      break;
-    unsigned idx = POP (candidates);
-    if (can_eliminate_variable (simplifier, idx)) {
-      eliminate_variable (simplifier, idx);
-      eliminated++;
+  if (threads > 1)
+    eliminated = eliminate_candidates_in_parallel (simplifier, &candidates,
+                                                   threads, round);
+  else
+    while (!EMPTY (candidates)) {
+      if (ruler->inconsistent)
+        break;
+      if (ruler->terminate)
+        break;
+      if (elimination_ticks_limit_hit (simplifier))
+        break;
+      unsigned idx = POP (candidates);
+      if (can_eliminate_variable (simplifier, idx)) {
+        eliminate_variable (simplifier, idx);
+        eliminated++;
+      }
     }
-    idx++;
-  }
 
 #ifndef QUIET
   unsigned remaining = SIZE (candidates);
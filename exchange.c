@@ -0,0 +1,284 @@
+#define _DEFAULT_SOURCE
+#include "exchange.h"
+#include "allocate.h"
+#include "message.h"
+#include "ruler.h"
+#include "utilities.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define EXCHANGE_MAGIC 0x67786368u
+
+static struct exchange_segment *open_exchange_segment (char *path) {
+  int fd = shm_open (path, O_CREAT | O_RDWR, 0600);
+  if (fd < 0)
+    fatal_error ("can not open shared memory segment '%s'", path);
+  size_t bytes = sizeof (struct exchange_segment);
+  struct stat buf;
+  if (fstat (fd, &buf))
+    fatal_error ("can not access shared memory segment '%s'", path);
+  if (buf.st_size && (size_t) buf.st_size != bytes)
+    fatal_error ("shared memory segment '%s' has size %zu (expected %zu)",
+                 path, (size_t) buf.st_size, bytes);
+  if (!buf.st_size && ftruncate (fd, bytes))
+    fatal_error ("can not resize shared memory segment '%s'", path);
+  void *memory =
+      mmap (0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (memory == MAP_FAILED)
+    fatal_error ("can not map shared memory segment '%s'", path);
+  return memory;
+}
+
+static struct exchange_segment *new_private_exchange_segment (void) {
+  size_t bytes = sizeof (struct exchange_segment);
+  void *memory = mmap (0, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED)
+    fatal_error ("can not map private exchange buffer");
+  return memory;
+}
+
+void attach_exchange (struct ruler *ruler) {
+  const char *name = ruler->options.exchange;
+  struct exchange_segment *segment;
+  char *path = 0;
+  if (name) {
+    size_t len = strlen (name);
+    path = allocate_block (len + 2);
+    if (*name == '/')
+      strcpy (path, name);
+    else
+      sprintf (path, "/%s", name);
+    segment = open_exchange_segment (path);
+  } else
+    segment = new_private_exchange_segment ();
+  unsigned expected = 0;
+  if (!atomic_compare_exchange_strong (&segment->magic, &expected,
+                                       EXCHANGE_MAGIC) &&
+      expected != EXCHANGE_MAGIC)
+    fatal_error ("invalid shared memory segment '%s'", path);
+  unsigned variables = ruler->size + 1;
+  expected = 0;
+  if (!atomic_compare_exchange_strong (&segment->variables, &expected,
+                                       variables) &&
+      expected != variables)
+    fatal_error ("shared memory segment '%s' used for %u variables "
+                 "(but formula has %u)",
+                 path, expected - 1, ruler->size);
+  uint64_t formula = ruler->exchange.formula | 1, previous = 0;
+  if (!atomic_compare_exchange_strong (&segment->formula, &previous,
+                                       formula) &&
+      previous != formula)
+    fatal_error ("shared memory segment '%s' used for a different formula",
+                 path);
+  unsigned attached = atomic_fetch_add (&segment->attached, 1) + 1;
+
+  struct exchange *exchange = &ruler->exchange;
+  exchange->segment = segment;
+  exchange->process = getpid ();
+  exchange->map = allocate_array (ruler->size, sizeof *exchange->map);
+  exchange->name = path;
+  map_exchange (ruler);
+
+  uint64_t head = atomic_load (&segment->head);
+  uint64_t start = 0;
+  if (head > SIZE_EXCHANGE_SLOTS)
+    start = head - SIZE_EXCHANGE_SLOTS;
+  for (all_rings (ring))
+    ring->exchanged = start;
+
+  if (path)
+    message (0, "attached to shared memory segment '%s' of %u processes",
+             path, attached);
+  (void) attached;
+}
+
+void detach_exchange (struct ruler *ruler) {
+  struct exchange *exchange = &ruler->exchange;
+  struct exchange_segment *segment = exchange->segment;
+  if (!segment)
+    return;
+  unsigned attached = atomic_fetch_sub (&segment->attached, 1);
+  munmap (segment, sizeof *segment);
+  if (attached == 1 && exchange->name) {
+    shm_unlink (exchange->name);
+    verbose (0, "removed shared memory segment '%s'", exchange->name);
+  }
+  free (exchange->name);
+  free (exchange->map);
+  exchange->segment = 0;
+}
+
+void map_exchange (struct ruler *ruler) {
+  struct exchange *exchange = &ruler->exchange;
+  if (!exchange->segment)
+    return;
+  unsigned *map = exchange->map;
+  for (unsigned idx = 0; idx != ruler->size; idx++)
+    map[idx] = INVALID;
+  unsigned *unmap = ruler->unmap;
+  for (all_ruler_indices (idx))
+    map[unmap ? unmap[idx] : idx] = idx;
+}
+
+// A writer only claims the slot of its ticket if no other writer (of an
+// older or newer lap) is still writing to it and it does not hold a newer
+// clause.  Otherwise the clause is dropped, since two writers modifying
+// the literals concurrently could produce a mixed clause which a reader
+// copying the slot in between could not distinguish from a valid one.
+
+void write_exchange_record (struct exchange_segment *segment,
+                            struct exchange_record *record) {
+  unsigned size = record->size;
+  assert (size <= SIZE_EXCHANGE_LITERALS);
+  uint64_t ticket = atomic_fetch_add_explicit (&segment->head, 1,
+                                               memory_order_relaxed);
+  struct exchange_slot *slot =
+      segment->slots + (ticket & (SIZE_EXCHANGE_SLOTS - 1));
+  uint64_t writing = 2 * ticket + 1, published = writing + 1;
+  uint64_t sequence =
+      atomic_load_explicit (&slot->sequence, memory_order_relaxed);
+  do {
+    if ((sequence & 1) || sequence >= published) {
+      atomic_store_explicit (&slot->skipped, ticket + 1,
+                             memory_order_release);
+      return;
+    }
+  } while (!atomic_compare_exchange_weak_explicit (
+      &slot->sequence, &sequence, writing, memory_order_relaxed,
+      memory_order_relaxed));
+  atomic_thread_fence (memory_order_release);
+  atomic_store_explicit (&slot->process, record->process,
+                         memory_order_relaxed);
+  atomic_store_explicit (&slot->size, size, memory_order_relaxed);
+  atomic_store_explicit (&slot->glue, record->glue, memory_order_relaxed);
+  for (unsigned i = 0; i != size; i++)
+    atomic_store_explicit (slot->literals + i, record->literals[i],
+                           memory_order_relaxed);
+  atomic_store_explicit (&slot->sequence, published, memory_order_release);
+}
+
+// Copies the next published slot after '*position' to 'record'.  Returns
+// 'false' if there is none.  Slots overwritten before or while copying
+// them or skipped by their writer are counted as 'lost'.
+
+bool read_exchange_record (struct exchange_segment *segment,
+                           uint64_t *position,
+                           struct exchange_record *record,
+                           uint64_t *lost) {
+  uint64_t head =
+      atomic_load_explicit (&segment->head, memory_order_relaxed);
+  while (*position < head) {
+    uint64_t ticket = *position;
+    if (head - ticket > SIZE_EXCHANGE_SLOTS) {
+      uint64_t start = head - SIZE_EXCHANGE_SLOTS;
+      *lost += start - ticket;
+      *position = start;
+      continue;
+    }
+    struct exchange_slot *slot =
+        segment->slots + (ticket & (SIZE_EXCHANGE_SLOTS - 1));
+    uint64_t published = 2 * ticket + 2;
+    uint64_t sequence =
+        atomic_load_explicit (&slot->sequence, memory_order_acquire);
+    if (sequence < published) {
+      if (atomic_load_explicit (&slot->skipped, memory_order_acquire) !=
+          ticket + 1)
+        return false;
+      *position = ticket + 1;
+      *lost += 1;
+      continue;
+    }
+    *position = ticket + 1;
+    if (sequence != published) {
+      *lost += 1;
+      continue;
+    }
+    record->process =
+        atomic_load_explicit (&slot->process, memory_order_relaxed);
+    unsigned size =
+        atomic_load_explicit (&slot->size, memory_order_relaxed);
+    record->glue =
+        atomic_load_explicit (&slot->glue, memory_order_relaxed);
+    if (size > SIZE_EXCHANGE_LITERALS)
+      size = 0;
+    for (unsigned i = 0; i != size; i++)
+      record->literals[i] = atomic_load_explicit (slot->literals + i,
+                                                  memory_order_relaxed);
+    atomic_thread_fence (memory_order_acquire);
+    if (atomic_load_explicit (&slot->sequence, memory_order_relaxed) !=
+        sequence) {
+      *lost += 1;
+      continue;
+    }
+    if (!size)
+      continue;
+    record->size = size;
+    return true;
+  }
+  return false;
+}
+
+void export_exchanged_clause (struct ring *ring, unsigned size,
+                              unsigned *literals, unsigned glue) {
+  assert (size <= SIZE_EXCHANGE_LITERALS);
+  struct ruler *ruler = ring->ruler;
+  struct exchange *exchange = &ruler->exchange;
+  struct exchange_record record;
+  record.process = exchange->process;
+  record.size = size;
+  record.glue = glue;
+  unsigned *unmap = ruler->unmap;
+  for (unsigned i = 0; i != size; i++)
+    record.literals[i] = unmap_and_export_literal (unmap, literals[i]);
+  write_exchange_record (exchange->segment, &record);
+  ring->statistics.exchanged.exported++;
+}
+
+static unsigned map_exchanged_literal (struct ruler *ruler, int literal) {
+  unsigned idx = literal < 0 ? -(unsigned) literal : (unsigned) literal;
+  if (!idx || idx > ruler->size)
+    return INVALID;
+  unsigned mapped = ruler->exchange.map[idx - 1];
+  if (mapped == INVALID)
+    return INVALID;
+  unsigned res = LIT (mapped);
+  if (literal < 0)
+    res = NOT (res);
+  return res;
+}
+
+// Returns the size of the next clause of another process which can be
+// imported (zero if there is none) and maps its literals to 'literals'.
+
+unsigned read_exchanged_clause (struct ring *ring, unsigned *literals,
+                                unsigned *glue) {
+  struct ruler *ruler = ring->ruler;
+  struct exchange *exchange = &ruler->exchange;
+  struct exchange_segment *segment = exchange->segment;
+  assert (segment);
+  struct exchange_record record;
+  uint64_t *lost = &ring->statistics.exchanged.lost;
+  while (read_exchange_record (segment, &ring->exchanged, &record, lost)) {
+    if (record.process == exchange->process)
+      continue;
+    unsigned size = record.size, i = 0;
+    while (i != size && (literals[i] = map_exchanged_literal (
+                             ruler, record.literals[i])) != INVALID)
+      i++;
+    if (i != size) {
+      ring->statistics.exchanged.unmapped++;
+      continue;
+    }
+    ring->statistics.exchanged.imported++;
+    *glue = record.glue;
+    return size;
+  }
+  return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef _exchange_h_INCLUDED
+#define _exchange_h_INCLUDED
+
+#include "options.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// With '--exchange=<name>' several solver processes working on the same
+// formula share units and low glue clauses through a named POSIX shared
+// memory segment holding a ring buffer of fixed size slots.  Writers
+// reserve a slot by incrementing 'head', which gives them a ticket.  They
+// then claim the slot by atomically setting its 'sequence' to the odd
+// number '2 * ticket + 1' and publish it by setting it to the even number
+// '2 * ticket + 2'.  A slot can only be claimed if no other writer is
+// writing to it and it does not hold a newer clause already.  Otherwise the
+// writer drops its clause and records its ticket in 'skipped' to let
+// readers skip it.  Readers check the sequence number before and after
+// copying a slot (as in a sequence lock) and thus detect slots claimed and
+// overwritten while reading.  Each ring has its own read position and skips
+// slots written by its own process.  Literals are stored in the original
+// variable numbering of the DIMACS file, since the processes compact
+// variables differently.  Imported clauses containing variables which are
+// not mapped in the importing process (because they were eliminated or
+// fixed there) are dropped.  Since a process crashing before detaching
+// leaves the segment behind, its header records a hash of the parsed
+// clauses, which has to match when attaching.  Without a name but in
+// distributed mode (see 'network.h') the buffer is private to the process.
+
+#define SIZE_EXCHANGE_SLOTS (1u << 14)
+#define SIZE_EXCHANGE_LITERALS 12
+
+struct ring;
+struct ruler;
+
+struct exchange_slot {
+  atomic_uint_fast64_t sequence;
+  atomic_uint_fast64_t skipped;
+  atomic_uint process;
+  atomic_ushort size;
+  atomic_ushort glue;
+  atomic_int literals[SIZE_EXCHANGE_LITERALS];
+};
+
+struct exchange_segment {
+  atomic_uint magic;
+  atomic_uint variables;
+  atomic_uint attached;
+  atomic_uint_fast64_t formula;
+  _Alignas (CACHE_LINE_SIZE) atomic_uint_fast64_t head;
+  _Alignas (CACHE_LINE_SIZE) struct exchange_slot
+      slots[SIZE_EXCHANGE_SLOTS];
+};
+
+struct exchange_record {
+  unsigned process;
+  unsigned size;
+  unsigned glue;
+  int literals[SIZE_EXCHANGE_LITERALS];
+};
+
+struct exchange {
+  struct exchange_segment *segment;
+  uint64_t formula;
+  unsigned process;
+  unsigned *map;
+  char *name;
+};
+
+void attach_exchange (struct ruler *);
+void detach_exchange (struct ruler *);
+void map_exchange (struct ruler *);
+
+bool read_exchange_record (struct exchange_segment *, uint64_t *position,
+                           struct exchange_record *, uint64_t *lost);
+void write_exchange_record (struct exchange_segment *,
+                            struct exchange_record *);
+
+void export_exchanged_clause (struct ring *, unsigned size,
+                              unsigned *literals, unsigned glue);
+unsigned read_exchanged_clause (struct ring *, unsigned *literals,
+                                unsigned *glue);
+
+#endif
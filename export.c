@@ -1,40 +1,34 @@
 #include "export.h"
+#include "exchange.h"
+#include "filter.h"
 #include "message.h"
 #include "random.h"
 #include "ruler.h"
+#include "telemetry.h"
 #include "utilities.h"
 
+#include <inttypes.h>
+
 void export_units (struct ring *ring) {
   struct ruler *ruler = ring->ruler;
   struct ring_units *units = &ring->ring_units;
-  volatile signed char *values = ruler->values;
+  atomic_schar *values = ruler->values;
   unsigned *end = units->end;
-  bool locked = false;
   while (units->export != end) {
     assert (units->export < units->end);
     unsigned unit = *units->export ++;
 #ifndef NFASTPATH
-    if (values[unit])
+    if (atomic_load_explicit (values + unit, memory_order_relaxed))
       continue;
 #endif
-    if (ring->pool && !locked) {
-      if (pthread_mutex_lock (&ruler->locks.units))
-        fatal_error ("failed to acquire unit lock");
-      locked = true;
-    }
-
-    signed char value = values[unit];
-    if (value)
+    if (!export_ruler_unit (ring, unit))
       continue;
-
     very_verbose (ring, "exporting unit %d",
                   unmap_and_export_literal (ruler->unmap, unit));
-    assign_ruler_unit (ruler, unit);
     INC_UNIT_CLAUSE_STATISTICS (exported);
+    if (ruler->exchange.segment)
+      export_exchanged_clause (ring, 1, &unit, 0);
   }
-
-  if (locked && pthread_mutex_unlock (&ruler->locks.units))
-    fatal_error ("failed to release unit lock");
 }
 
 static bool exporting (struct ring *ring) {
@@ -46,7 +40,7 @@ static bool exporting (struct ring *ring) {
   return true;
 }
 
-static struct rings *export_rings (struct ring *ring) {
+static struct rings *export_rings (struct ring *ring, bool tier1) {
 
   struct ruler *ruler = ring->ruler;
   struct rings *rings = &ruler->rings;
@@ -76,6 +70,12 @@ static struct rings *export_rings (struct ring *ring) {
       PUSH (*exports, other);
     CONTINUE:;
     } while (SIZE (*exports) != target);
+  } else if (export == 4) {
+    LOG ("export to rings in domain %u%s", ring->domain,
+         tier1 ? " and other domains" : "");
+    for (all_pointers_on_stack (struct ring, other, *rings))
+      if (other != ring && (tier1 || other->domain == ring->domain))
+        PUSH (*exports, other);
   } else {
     LOG ("export to all %u other rings", size - 1);
     for (all_pointers_on_stack (struct ring, other, *rings))
@@ -86,7 +86,61 @@ static struct rings *export_rings (struct ring *ring) {
   return exports;
 }
 
-static void export_to_ring (struct ring *ring, struct ring *other,
+static void shrink_pool (struct ring *ring, struct pool *pool,
+                         unsigned new_capacity) {
+  unsigned capacity = pool->capacity;
+  assert (new_capacity < capacity);
+  atomic_store_explicit (&pool->capacity, new_capacity,
+                         memory_order_relaxed);
+  struct bucket *end = pool->bucket + capacity;
+  for (struct bucket *b = pool->bucket + new_capacity; b != end; b++) {
+    uintptr_t ptr = atomic_exchange (&b->shared, 0);
+    if (!ptr)
+      continue;
+    b->redundancy = MAX_REDUNDANCY;
+    struct clause *clause = (struct clause *) ptr;
+    if (!is_binary_pointer (clause))
+      defer_dereference_clause (ring, clause);
+    pool->dropped++;
+  }
+}
+
+static void adapt_pool (struct ring *ring, struct ring *other,
+                        struct pool *pool) {
+  uint64_t exports = pool->exported;
+  if (exports < pool->adapt.next)
+    return;
+  uint64_t imported =
+      atomic_load_explicit (&pool->imported, memory_order_relaxed);
+  uint64_t lost = pool->overwritten + pool->dropped;
+  uint64_t delta_imported = imported - pool->adapt.imported;
+  uint64_t delta_lost = lost - pool->adapt.lost;
+  unsigned capacity = pool->capacity;
+  unsigned new_capacity = capacity;
+  if (delta_lost > delta_imported && delta_imported >= capacity &&
+      capacity < SIZE_POOL)
+    new_capacity = 2 * capacity;
+  else if (2 * delta_imported < capacity && capacity > MIN_POOL)
+    new_capacity = capacity / 2;
+  if (new_capacity != capacity) {
+    very_verbose (ring,
+                  "resizing pool to ring %u from %u to %u buckets "
+                  "(imported %" PRIu64 " lost %" PRIu64 ")",
+                  other->id, capacity, new_capacity, delta_imported,
+                  delta_lost);
+    if (new_capacity < capacity)
+      shrink_pool (ring, pool, new_capacity);
+    else
+      atomic_store_explicit (&pool->capacity, new_capacity,
+                             memory_order_relaxed);
+    pool->resized++;
+  }
+  pool->adapt.next = exports + POOL_ADAPT_PERIOD * new_capacity;
+  pool->adapt.imported = imported;
+  pool->adapt.lost = pool->overwritten + pool->dropped;
+}
+
+static bool export_to_ring (struct ring *ring, struct ring *other,
                             struct clause *clause, unsigned glue,
                             unsigned size, uint64_t redundancy) {
   LOG ("trying to export to target ring %u with redundancy [%u:%u]",
@@ -94,9 +148,20 @@ static void export_to_ring (struct ring *ring, struct ring *other,
   assert (ring != other);
 
   struct pool *pool = ring->pool + other->id;
+  pool->offered++;
+  if (ring->options.import_feedback &&
+      glue > ring->tier1_glue_limit[ring->stable] &&
+      atomic_load_explicit (&other->sources[ring->id].throttle,
+                            memory_order_relaxed)) {
+    LOG ("export to ring %u throttled", other->id);
+    pool->throttled++;
+    return false;
+  }
+  if (ring->options.adapt_pools)
+    adapt_pool (ring, other, pool);
 
   struct bucket *start = pool->bucket;
-  struct bucket *end = start + SIZE_POOL;
+  struct bucket *end = start + pool->capacity;
   struct bucket *worst = 0;
 
   uint64_t worst_redundancy = 0;
@@ -118,7 +183,8 @@ static void export_to_ring (struct ring *ring, struct ring *other,
     LOG ("export to ring %u failed "
          "as all its buckets have better redundancy",
          other->id);
-    return;
+    pool->dropped++;
+    return false;
   }
 
 #ifdef LOGGING
@@ -129,12 +195,13 @@ static void export_to_ring (struct ring *ring, struct ring *other,
     LOG ("exporting to ring %u bucket %zu with redundancy [%u:%u]",
          other->id, worst - start, LOG_REDUNDANCY (worst_redundancy));
 #endif
-  if (!is_binary_pointer (clause))
-    reference_clause (ring, clause, 1);
+  if (ring->options.telemetry)
+    stamp_exported_clause (other, pool, worst);
 
   atomic_uintptr_t *share = &worst->shared;
   uintptr_t ptr = atomic_exchange (share, (uintptr_t) clause);
   worst->redundancy = redundancy;
+  pool->exported++;
 
   if (ptr) {
     assert (worst_redundancy != MAX_REDUNDANCY);
@@ -142,17 +209,23 @@ static void export_to_ring (struct ring *ring, struct ring *other,
          other->id, worst - start, LOG_REDUNDANCY (worst_redundancy));
     struct clause *previous = (struct clause *) ptr;
     if (!is_binary_pointer (previous))
-      dereference_clause (ring, previous);
+      defer_dereference_clause (ring, previous);
+    pool->overwritten++;
   } else if (worst_redundancy != MAX_REDUNDANCY) {
     LOG ("previous export to ring %u bucket %zu redundancy [%u:%u] "
          "succeeded",
          other->id, worst - start, LOG_REDUNDANCY (worst_redundancy));
     INC_LARGE_CLAUSE_STATISTICS (exported, glue, size);
   }
+  return true;
 }
 
 static void export_clause (struct ring *ring, struct clause *clause) {
   assert (exporting (ring));
+  if (filter_exported_clause (ring, clause)) {
+    LOG ("not exporting recently exported duplicate clause");
+    return;
+  }
   bool binary = is_binary_pointer (clause);
   unsigned glue = binary ? 1 : clause->glue;
   unsigned size = binary ? 2 : clause->size;
@@ -160,15 +233,31 @@ static void export_clause (struct ring *ring, struct clause *clause) {
   uint64_t high = share_by_size ? size : glue;
   uint64_t low = share_by_size ? glue : size;
   uint64_t redundancy = (high << 32) + low;
-  struct rings *exports = export_rings (ring);
+  bool tier1 = glue <= ring->tier1_glue_limit[ring->stable];
+  struct rings *exports = export_rings (ring, tier1);
+  unsigned targets = SIZE (*exports);
+  if (!targets)
+    return;
+  if (!binary)
+    reference_clause (ring, clause, targets);
+  unsigned unused = 0;
   for (all_pointers_on_stack (struct ring, other, *exports))
-    export_to_ring (ring, other, clause, glue, size, redundancy);
+    if (!export_to_ring (ring, other, clause, glue, size, redundancy))
+      unused++;
+  if (!binary && unused)
+    dereference_clause_times (ring, clause, unused);
 }
 
 void export_binary_clause (struct ring *ring, struct watch *watch) {
   assert (is_binary_pointer (watch));
+  if (ring->ruler->exchange.segment) {
+    unsigned literals[2] = {lit_pointer (watch), other_pointer (watch)};
+    export_exchanged_clause (ring, 2, literals, 1);
+  }
   if (!exporting (ring))
     return;
+  if (ring->ruler->store.chunks)
+    return;
   LOGWATCH (watch, "exporting");
   struct clause *clause = (struct clause *) watch;
   export_clause (ring, clause);
@@ -176,6 +265,11 @@ void export_binary_clause (struct ring *ring, struct watch *watch) {
 
 void export_large_clause (struct ring *ring, struct clause *clause) {
   assert (!is_binary_pointer (clause));
+  if (ring->ruler->exchange.segment &&
+      clause->glue <= ring->tier1_glue_limit[ring->stable] &&
+      clause->size <= SIZE_EXCHANGE_LITERALS)
+    export_exchanged_clause (ring, clause->size, clause->literals,
+                             clause->glue);
   if (!exporting (ring))
     return;
   struct averages *a = ring->averages + ring->stable;
@@ -219,11 +313,13 @@ void flush_pool (struct ring *ring) {
         continue;
       struct clause *clause = (struct clause *) ptr;
       if (!is_binary_pointer (clause))
-        dereference_clause (ring, clause);
+        defer_dereference_clause (ring, clause);
+      pool->dropped++;
 #ifndef QUIET
       flushed++;
 #endif
     }
   }
+  reconcile_deferred_dereferences (ring);
   very_verbose (ring, "flushed %zu clauses to be exported", flushed);
 }
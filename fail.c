@@ -62,7 +62,7 @@ void failed_literal_probing (struct ring *ring) {
     if (import_shared (ring)) {
       if (ring->inconsistent)
         break;
-      if (ring_propagate (ring, false, 0)) {
+      if (probing_propagate (ring)) {
         set_inconsistent (
             ring, "unit propagation fails after importing shared clauses "
                   "during failed literal probing");
@@ -83,7 +83,7 @@ void failed_literal_probing (struct ring *ring) {
     struct ring_trail *trail = &ring->trail;
     unsigned *saved = trail->propagate;
     assert (saved + 1 == trail->end);
-    bool ok = !ring_propagate (ring, false, 0);
+    bool ok = !probing_propagate (ring);
     unsigned unit = INVALID;
     if (ok) {
       unsigned not_probe = NOT (probe);
@@ -135,7 +135,7 @@ void failed_literal_probing (struct ring *ring) {
           trace_delete_binary (&ring->trace, not_probe, unit);
           trace_delete_binary (&ring->trace, probe, unit);
           assign_ring_unit (ring, unit);
-          if (ring_propagate (ring, false, 0)) {
+          if (probing_propagate (ring)) {
             trace_add_empty (&ring->trace);
             set_inconsistent (
                 ring, "propagating of lifted literal yields empty clause "
@@ -163,7 +163,7 @@ void failed_literal_probing (struct ring *ring) {
       unit = NOT (probe);
       trace_add_unit (&ring->trace, unit);
       assign_ring_unit (ring, unit);
-      if (ring_propagate (ring, false, 0)) {
+      if (probing_propagate (ring)) {
         trace_add_empty (&ring->trace);
         set_inconsistent (
             ring, "propagation of failed literal yields empty clause");
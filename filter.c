@@ -0,0 +1,67 @@
+#include "filter.h"
+#include "allocate.h"
+#include "ruler.h"
+
+#include <string.h>
+
+void init_filter (struct ruler *ruler) {
+  unsigned log2_size = ruler->options.export_filter;
+  if (!log2_size)
+    return;
+  struct filter *filter = &ruler->filter;
+  filter->size = (size_t) 1 << log2_size;
+  filter->table =
+      allocate_and_clear_array (filter->size, sizeof *filter->table);
+}
+
+void clear_filter (struct ruler *ruler) {
+  struct filter *filter = &ruler->filter;
+  if (filter->table)
+    memset (filter->table, 0, filter->size * sizeof *filter->table);
+}
+
+void release_filter (struct ruler *ruler) {
+  free (ruler->filter.table);
+}
+
+static uint64_t hash_literal (unsigned lit) {
+  uint64_t res = lit + 1;
+  res *= 0x9e3779b97f4a7c15ull;
+  res ^= res >> 29;
+  res *= 0xbf58476d1ce4e5b9ull;
+  res ^= res >> 32;
+  return res;
+}
+
+static uint64_t fingerprint (struct clause *clause) {
+  uint64_t res = 0;
+  unsigned size;
+  if (is_binary_pointer (clause)) {
+    res += hash_literal (lit_pointer (clause));
+    res += hash_literal (other_pointer (clause));
+    size = 2;
+  } else {
+    for (all_literals_in_clause (lit, clause))
+      res += hash_literal (lit);
+    size = clause->size;
+  }
+  res ^= hash_literal (size);
+  return res ? res : 1;
+}
+
+bool filter_exported_clause (struct ring *ring, struct clause *clause) {
+  struct filter *filter = &ring->ruler->filter;
+  if (!filter->table)
+    return false;
+  uint64_t hash = fingerprint (clause);
+  size_t pos = (hash >> 32) & (filter->size - 1);
+  atomic_uint_fast64_t *entry = filter->table + pos;
+  ring->statistics.filter.checked++;
+  if (atomic_load_explicit (entry, memory_order_relaxed) == hash ||
+      atomic_exchange_explicit (entry, hash, memory_order_relaxed) ==
+          hash) {
+    ring->statistics.filter.duplicates++;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,31 @@
+#ifndef _filter_h_INCLUDED
+#define _filter_h_INCLUDED
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Rings often learn and export the same clause, particularly short ones.
+// Before exporting a clause it is looked up in a global fixed-size table
+// of fingerprints of recently exported clauses.  The fingerprint does not
+// depend on the order of literals.  Lookup and insertion are combined into
+// a single atomic exchange of the table entry and thus lock-free.  Hash
+// collisions on different fingerprints just overwrite older entries.  The
+// table has to be cleared whenever variables are renumbered.
+
+struct clause;
+struct ring;
+struct ruler;
+
+struct filter {
+  atomic_uint_fast64_t *table;
+  size_t size;
+};
+
+void init_filter (struct ruler *);
+void clear_filter (struct ruler *);
+void release_filter (struct ruler *);
+
+bool filter_exported_clause (struct ring *, struct clause *);
+
+#endif
@@ -6,4 +6,12 @@
 #define GIMSATUL_HAS_POSIX_MEMALIGN
 #endif
 
+#if !defined(NPREFETCH) && defined(__GNUC__)
+#define GIMSATUL_HAS_PREFETCH
+#endif
+
+#if !defined(NSIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define GIMSATUL_HAS_AVX2
+#endif
+
 #endif
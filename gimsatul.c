@@ -3,12 +3,14 @@
 #include "clone.h"
 #include "detach.h"
 #include "message.h"
+#include "network.h"
 #include "parse.h"
 #include "ruler.h"
 #include "simplify.h"
 #include "solve.h"
 #include "statistics.h"
 #include "system.h"
+#include "telemetry.h"
 #include "types.h"
 #include "witness.h"
 
@@ -37,13 +39,16 @@ int main (int argc, char **argv) {
   int res = winner ? winner->status : 0;
   reset_signal_handlers ();
   close_proof (&options.proof);
+  signed char *witness = 0;
+  if (res == 10)
+    witness = extend_witness (winner);
+  res = finish_network (ruler, res, &witness);
   if (res == 20) {
     if (verbosity >= 0)
       printf ("c\n");
     printf ("s UNSATISFIABLE\n");
     fflush (stdout);
   } else if (res == 10) {
-    signed char *witness = extend_witness (winner);
     check_witness (witness, ruler->original);
     if (verbosity >= 0)
       printf ("c\n");
@@ -59,6 +64,8 @@ int main (int argc, char **argv) {
   else
     print_ruler_statistics (ruler);
 #endif
+  if (options.telemetry)
+    dump_telemetry (ruler);
   detach_and_delete_rings (ruler);
   delete_ruler (ruler);
   if (verbosity >= 0) {
@@ -2,56 +2,64 @@
 #include "assign.h"
 #include "backtrack.h"
 #include "bump.h"
+#include "exchange.h"
 #include "message.h"
 #include "propagate.h"
 #include "random.h"
 #include "ring.h"
 #include "ruler.h"
+#include "telemetry.h"
 #include "trace.h"
 #include "utilities.h"
 
+#include <inttypes.h>
+
+// Returns 'false' if the unit is already satisfied at the root level.
+
+static bool import_unit (struct ring *ring, unsigned unit) {
+  LOG ("trying to import unit %s", LOGLIT (unit));
+  signed char *values = ring->values;
+  signed char value = values[unit];
+  struct variable *v = VAR (unit);
+  if (value && v->level) {
+    backtrack (ring, v->level - 1);
+    assert (!values[unit]);
+    value = 0;
+  }
+  if (value > 0) {
+    assert (!v->level);
+    return false;
+  }
+  very_verbose (ring, "importing unit %d",
+                unmap_and_export_literal (ring->ruler->unmap, unit));
+  INC_UNIT_CLAUSE_STATISTICS (imported);
+  if (value < 0) {
+    assert (!v->level);
+    set_inconsistent (ring, "imported falsified unit");
+  } else
+    assign_ring_unit (ring, unit);
+  return true;
+}
+
 static bool import_units (struct ring *ring) {
   assert (ring->pool);
   struct ruler *ruler = ring->ruler;
-#ifndef NFASTPATH
-  if (ring->ruler_units == ruler->units.end)
+  unsigned *end =
+      atomic_load_explicit (&ruler->units.end, memory_order_acquire);
+  unsigned *p = ring->ruler_units;
+  if (p == end)
     return false;
-#endif
-  struct variable *variables = ring->variables;
-  signed char *values = ring->values;
   unsigned imported = 0;
-  if (pthread_mutex_lock (&ruler->locks.units))
-    fatal_error ("failed to acquire unit lock");
-  while (ring->ruler_units != ruler->units.end) {
-    unsigned unit = *ring->ruler_units++;
-    LOG ("trying to import unit %s", LOGLIT (unit));
-    signed char value = values[unit];
-    unsigned unit_idx = IDX (unit);
-    struct variable *v = variables + unit_idx;
-    if (value && v->level) {
-      backtrack (ring, v->level - 1);
-      assert (!values[unit]);
-      value = 0;
-    }
-    if (value > 0) {
-      assert (!v->level);
+  while (p != end) {
+    unsigned unit = *p++;
+    if (!import_unit (ring, unit))
       continue;
-    }
-    very_verbose (ring, "importing unit %d",
-                  unmap_and_export_literal (ruler->unmap, unit));
-    INC_UNIT_CLAUSE_STATISTICS (imported);
     assert (imported < UINT_MAX);
     imported++;
-    if (value < 0) {
-      assert (!v->level);
-      set_inconsistent (ring, "imported falsified unit");
-      imported = INVALID;
+    if (ring->inconsistent)
       break;
-    }
-    assign_ring_unit (ring, unit);
   }
-  if (pthread_mutex_unlock (&ruler->locks.units))
-    fatal_error ("failed to release unit lock");
+  atomic_store_explicit (&ring->ruler_units, p, memory_order_relaxed);
   if (ring->inconsistent)
     return true;
   if (!imported)
@@ -61,9 +69,14 @@ static bool import_units (struct ring *ring) {
 }
 
 static void really_import_binary_clause (struct ring *ring, unsigned lit,
-                                         unsigned other) {
-  (void) new_local_binary_clause (ring, true, lit, other);
-  trace_add_binary (&ring->trace, lit, other);
+                                         unsigned other, bool stored) {
+  if (ring->ruler->store.chunks) {
+    if (!stored)
+      (void) add_stored_binary (ring, lit, other);
+  } else {
+    (void) new_local_binary_clause (ring, true, lit, other);
+    trace_add_binary (&ring->trace, lit, other);
+  }
   INC_BINARY_CLAUSE_STATISTICS (imported);
 }
 
@@ -76,7 +89,10 @@ static void force_to_repropagate (struct ring *ring, unsigned lit) {
   unsigned *propagate = ring->trail.begin + pos;
   assert (propagate < ring->trail.end);
   assert (*propagate == NOT (lit));
-  assert (propagate < ring->trail.propagate);
+  if (propagate >= ring->trail.propagate) {
+    assert (ring->options.import_batch);
+    return;
+  }
   ring->trail.propagate = propagate;
   LOG ("setting end of trail to %zu", pos);
   if (!ring->level)
@@ -88,11 +104,12 @@ static bool subsumed_binary (struct ring *ring, unsigned lit,
   if (!ring->options.subsume_imported)
     return false;
   ring->statistics.subsumed.binary.checked++;
-  if (SIZE (REFERENCES (lit)) > SIZE (REFERENCES (other)))
+  if (SIZE (REFERENCES (lit).redundant) >
+      SIZE (REFERENCES (other).redundant))
     SWAP (unsigned, lit, other);
   bool res = false;
-  for (all_watches (watch, REFERENCES (lit)))
-    if (is_binary_pointer (watch) && other_pointer (watch) == other) {
+  for (all_elements_on_stack (unsigned, tmp, REFERENCES (lit).redundant))
+    if (tmp == other) {
       res = true;
       ring->statistics.subsumed.binary.succeeded++;
       break;
@@ -100,7 +117,8 @@ static bool subsumed_binary (struct ring *ring, unsigned lit,
   return res;
 }
 
-static bool import_binary (struct ring *ring, struct clause *clause) {
+static bool import_binary (struct ring *ring, struct clause *clause,
+                           unsigned source, bool stored) {
   assert (is_binary_pointer (clause));
   assert (redundant_pointer (clause));
   signed char *values = ring->values;
@@ -137,6 +155,8 @@ static bool import_binary (struct ring *ring, struct clause *clause) {
   do { \
     if (subsumed_binary (ring, LIT, OTHER)) { \
       LOGBINARY (true, LIT, OTHER, "subsumed imported"); \
+      if (source != ring->id) \
+        ring->sources[source].subsumed++; \
       return false; \
     } \
   } while (0)
@@ -146,14 +166,14 @@ static bool import_binary (struct ring *ring, struct clause *clause) {
   if (other_value >= 0) {
     SUBSUME_BINARY (lit, other);
     LOGBINARY (true, lit, other, "importing (no propagation)");
-    really_import_binary_clause (ring, lit, other);
+    really_import_binary_clause (ring, lit, other, stored);
     return false;
   }
 
   if (lit_value > 0 && lit_level <= other_level) {
     SUBSUME_BINARY (lit, other);
     LOGBINARY (true, lit, other, "importing (no propagation)");
-    really_import_binary_clause (ring, lit, other);
+    really_import_binary_clause (ring, lit, other, stored);
     if (lit_level < other_level && ring->context == PROBING_CONTEXT) {
       ring->statistics.diverged++;
       return true;
@@ -171,7 +191,7 @@ static bool import_binary (struct ring *ring, struct clause *clause) {
     LOGBINARY (true, lit, other, "importing (repropagate first watch %s)",
                LOGLIT (lit));
     force_to_repropagate (ring, lit);
-    really_import_binary_clause (ring, lit, other);
+    really_import_binary_clause (ring, lit, other, stored);
     return true;
   }
 
@@ -182,7 +202,7 @@ static bool import_binary (struct ring *ring, struct clause *clause) {
   LOGBINARY (true, lit, other, "importing (repropagate second watch %s))",
              LOGLIT (other));
   force_to_repropagate (ring, other);
-  really_import_binary_clause (ring, lit, other);
+  really_import_binary_clause (ring, lit, other, stored);
 
   return true;
 }
@@ -195,6 +215,7 @@ static bool subsumed_large_clause (struct ring *ring,
   signed char *values = ring->values;
   struct variable *variables = ring->variables;
   signed char *marks = ring->marks;
+  uint64_t signature = clause->signature;
   unsigned max_occurrences_lit = INVALID;
   size_t max_occurrences = 0;
   for (all_literals_in_clause (lit, clause)) {
@@ -208,7 +229,7 @@ static bool subsumed_large_clause (struct ring *ring,
     if (value < 0)
       continue;
     struct references *watches = &REFERENCES (lit);
-    size_t tmp_occurrences = SIZE (*watches);
+    size_t tmp_occurrences = SIZE (*watches) + SIZE (watches->redundant);
     if (tmp_occurrences <= max_occurrences)
       continue;
     max_occurrences = tmp_occurrences;
@@ -222,7 +243,26 @@ static bool subsumed_large_clause (struct ring *ring,
     if (lit_value < 0)
       continue;
     struct references *watches = &REFERENCES (lit);
+    for (all_elements_on_stack (unsigned, other, watches->redundant)) {
+      assert (lit != other);
+      signed char other_mark = marks[other];
+      if (!other_mark) {
+        signed char other_value = values[other];
+        if (other_value >= 0)
+          continue;
+        unsigned other_idx = IDX (other);
+        struct variable *v = variables + other_idx;
+        if (v->level)
+          continue;
+      }
+      res = true;
+      LOGBINARY (true, lit, other, "subsuming");
+      break;
+    }
+    if (res)
+      break;
     for (all_watches (watch, *watches)) {
+      assert (!is_binary_pointer (watch));
       if (!redundant_pointer (watch))
         continue;
       unsigned blocking = other_pointer (watch);
@@ -237,12 +277,18 @@ static bool subsumed_large_clause (struct ring *ring,
         if (v->level)
           continue;
       }
-      if (is_binary_pointer (watch)) {
-        res = true;
-        LOGWATCH (watch, "subsuming");
-        break;
-      }
       struct watcher *watcher = get_watcher (ring, watch);
+      // Only large clauses which are not cached in the watcher are
+      // filtered by signature.  Since the signature also covers literals
+      // fixed to false at the root-level, which are otherwise ignored,
+      // a few subsuming clauses might be missed.
+      if (!watcher->size) {
+        ring->statistics.subsumed.signatures.checked++;
+        if (!subset_signature (watcher->clause->signature, signature)) {
+          ring->statistics.subsumed.signatures.filtered++;
+          continue;
+        }
+      }
       res = true;
       for (all_watcher_literals (other, watcher)) {
         if (other == lit)
@@ -279,8 +325,15 @@ static bool subsumed_large_clause (struct ring *ring,
 
 static void really_import_large_clause (struct ring *ring,
                                         struct clause *clause,
-                                        unsigned first, unsigned second) {
-  watch_literals_in_large_clause (ring, clause, first, second);
+                                        unsigned source, unsigned first,
+                                        unsigned second) {
+  struct watch *watch =
+      watch_literals_in_large_clause (ring, clause, first, second);
+  unsigned idx = index_pointer (watch);
+  struct watcher_usage *usage = index_to_usage (ring, idx);
+  usage->source = source;
+  if (source != ring->id)
+    ring->sources[source].imported++;
   assert (clause->redundant);
   INC_LARGE_CLAUSE_STATISTICS (imported, clause->glue, clause->size);
 }
@@ -322,7 +375,8 @@ static unsigned find_literal_to_watch (struct ring *ring,
   return res;
 }
 
-static bool import_large_clause (struct ring *ring, struct clause *clause) {
+static bool import_large_clause (struct ring *ring, struct clause *clause,
+                                 unsigned source) {
   signed char *values = ring->values;
   for (all_literals_in_clause (lit, clause)) {
     if (values[lit] <= 0)
@@ -330,7 +384,7 @@ static bool import_large_clause (struct ring *ring, struct clause *clause) {
     if (VAR (lit)->level)
       continue;
     LOGCLAUSE (clause, "not importing %s satisfied", LOGLIT (lit));
-    dereference_clause (ring, clause);
+    defer_dereference_clause (ring, clause);
     return false;
   }
 
@@ -349,7 +403,9 @@ static bool import_large_clause (struct ring *ring, struct clause *clause) {
 #define SUBSUME_LARGE_CLAUSE(CLAUSE) \
   do { \
     if (subsumed_large_clause (ring, clause)) { \
-      dereference_clause (ring, clause); \
+      defer_dereference_clause (ring, clause); \
+      if (source != ring->id) \
+        ring->sources[source].subsumed++; \
       return false; \
     } \
   } while (0)
@@ -359,14 +415,14 @@ static bool import_large_clause (struct ring *ring, struct clause *clause) {
   if (other_value >= 0) {
     SUBSUME_LARGE_CLAUSE (clause);
     LOGCLAUSE (clause, "importing (no propagation)");
-    really_import_large_clause (ring, clause, lit, other);
+    really_import_large_clause (ring, clause, source, lit, other);
     return false;
   }
 
   if (lit_value > 0 && lit_level <= other_level) {
     SUBSUME_LARGE_CLAUSE (clause);
     LOGCLAUSE (clause, "importing (no propagation)");
-    really_import_large_clause (ring, clause, lit, other);
+    really_import_large_clause (ring, clause, source, lit, other);
     if (lit_level < other_level && ring->context == PROBING_CONTEXT) {
       ring->statistics.diverged++;
       return true;
@@ -384,7 +440,7 @@ static bool import_large_clause (struct ring *ring, struct clause *clause) {
     LOGCLAUSE (clause, "importing (repropagate first watch %s)",
                LOGLIT (lit));
     force_to_repropagate (ring, lit);
-    really_import_large_clause (ring, clause, lit, other);
+    really_import_large_clause (ring, clause, source, lit, other);
     return true;
   }
 
@@ -395,27 +451,222 @@ static bool import_large_clause (struct ring *ring, struct clause *clause) {
   LOGCLAUSE (clause, "importing (repropagate second watch %s)",
              LOGLIT (other));
   force_to_repropagate (ring, other);
-  really_import_large_clause (ring, clause, lit, other);
+  really_import_large_clause (ring, clause, source, lit, other);
 
   return true;
 }
 
+static struct clause *take_shared_clause (struct ring *ring,
+                                          unsigned source,
+                                          struct pool *pool,
+                                          struct bucket *bucket) {
+  atomic_uintptr_t *p = &bucket->shared;
+  struct clause *clause = (struct clause *) atomic_exchange (p, 0);
+  if (!clause)
+    return 0;
+  if (ring->options.telemetry)
+    sample_import_latency (ring, ring->sources + source, pool, bucket);
+  uint64_t imported =
+      atomic_load_explicit (&pool->imported, memory_order_relaxed);
+  atomic_store_explicit (&pool->imported, imported + 1,
+                         memory_order_relaxed);
+  return clause;
+}
+
+static bool import_clause (struct ring *ring, struct clause *clause,
+                           unsigned source) {
+  if (is_binary_pointer (clause))
+    return import_binary (ring, clause, source, false);
+  return import_large_clause (ring, clause, source);
+}
+
+static struct ring *select_useful_source (struct ring *ring) {
+  struct ruler *ruler = ring->ruler;
+  struct rings *rings = &ruler->rings;
+  unsigned threads = SIZE (*rings);
+  struct source *sources = ring->sources;
+  double sum = 0;
+  for (unsigned id = 0; id != threads; id++)
+    if (id != ring->id)
+      sum += sources[id].weight;
+  double remaining = sum * random_double (&ring->random);
+  unsigned res = INVALID;
+  for (unsigned id = 0; id != threads; id++) {
+    if (id == ring->id)
+      continue;
+    res = id;
+    remaining -= sources[id].weight;
+    if (remaining < 0)
+      break;
+  }
+  assert (res != INVALID);
+  return PEEK (*rings, res);
+}
+
+void update_import_feedback (struct ring *ring) {
+  if (!ring->pool)
+    return;
+  if (!ring->options.import_feedback)
+    return;
+  unsigned threads = ring->threads;
+  struct source *sources = ring->sources;
+  double sum = 0;
+  for (unsigned id = 0; id != threads; id++) {
+    if (id == ring->id)
+      continue;
+    struct source *s = sources + id;
+    s->recent.imported = 0.5 * s->recent.imported;
+    s->recent.imported += s->imported - s->last.imported;
+    s->recent.used = 0.5 * s->recent.used;
+    s->recent.used += s->used - s->last.used;
+    s->last.imported = s->imported;
+    s->last.used = s->used;
+    s->weight = (s->recent.used + 1) / (s->recent.imported + 1);
+    sum += s->weight;
+  }
+  double limit = 0.5 * sum / (threads - 1);
+  for (unsigned id = 0; id != threads; id++) {
+    if (id == ring->id)
+      continue;
+    struct source *s = sources + id;
+    bool throttle = s->weight < limit;
+    atomic_store_explicit (&s->throttle, throttle, memory_order_relaxed);
+    very_verbose (ring, "source ring %u usefulness %.2f%s", id, s->weight,
+                  throttle ? " throttled" : "");
+  }
+}
+
+// In batched mode all pools of all other rings are drained (starting at a
+// random ring) until the tick budget is exhausted.  The assignment does
+// not change while importing, thus the watches of all imported clauses
+// can be selected as in single clause mode, and the forced propagation
+// merely goes back to the earliest position needed by any of them.  This
+// replaces one backtrack or repropagation per clause by a single one.
+
+static bool import_batch (struct ring *ring) {
+  struct ruler *ruler = ring->ruler;
+  struct rings *rings = &ruler->rings;
+  unsigned threads = SIZE (*rings);
+  assert (threads > 1);
+  uint64_t budget = ring->options.import_batch;
+  uint64_t ticks = 0;
+  unsigned start = random_modulo (&ring->random, threads);
+  unsigned imported = 0;
+  bool res = false;
+  for (unsigned i = 0; i != threads && ticks < budget; i++) {
+    unsigned id = start + i;
+    if (id >= threads)
+      id -= threads;
+    if (id == ring->id)
+      continue;
+    struct ring *src = PEEK (*rings, id);
+    struct pool *pool = src->pool + ring->id;
+    unsigned capacity =
+        atomic_load_explicit (&pool->capacity, memory_order_relaxed);
+    struct bucket *end = pool->bucket + capacity;
+    for (struct bucket *b = pool->bucket; b != end && ticks < budget;
+         b++) {
+      if (!b->shared)
+        continue;
+      struct clause *clause = take_shared_clause (ring, id, pool, b);
+      if (!clause)
+        continue;
+      LOG ("batched import from ring %u bucket %zu", id,
+           b - pool->bucket);
+      if (is_binary_pointer (clause))
+        ticks++;
+      else
+        ticks += 1 + cache_lines (clause->literals + clause->size,
+                                  clause->literals);
+      imported++;
+      if (import_clause (ring, clause, id))
+        res = true;
+    }
+  }
+  if (imported) {
+    ring->statistics.batched.batches++;
+    ring->statistics.batched.clauses += imported;
+    ring->statistics.batched.ticks += ticks;
+  }
+  LOG ("batched import of %u clauses with %" PRIu64 " ticks", imported,
+       ticks);
+  return res;
+}
+
+// Clauses of other processes are imported as if they were exported by
+// the importing ring itself, which keeps them out of the usefulness
+// statistics of the source rings.  Units are also published to the other
+// rings of this process on the global unit trail, which in turn prevents
+// exporting them back to the exchange.
+
+static bool import_exchanged (struct ring *ring) {
+  unsigned literals[SIZE_EXCHANGE_LITERALS], glue, size;
+  while ((size = read_exchanged_clause (ring, literals, &glue))) {
+    if (size == 1) {
+      unsigned unit = literals[0];
+      if (!import_unit (ring, unit))
+        continue;
+      if (!ring->inconsistent) {
+        (void) export_ruler_unit (ring, unit);
+        ring->iterating = -1;
+      }
+      return true;
+    }
+    struct clause *clause;
+    if (size == 2)
+      clause = tag_binary (true, literals[0], literals[1]);
+    else
+      clause = new_large_clause (ring->arena, size, literals, true, glue);
+    if (import_clause (ring, clause, ring->id))
+      return true;
+  }
+  return false;
+}
+
+// Binary clauses added to the global store by other rings are already
+// watched (see 'store.h') but might have to be propagated.
+
+static bool import_stored_binaries (struct ring *ring) {
+  unsigned lit, other, source;
+  while (next_stored_binary (ring, &lit, &other, &source)) {
+    struct clause *clause = tag_binary (true, lit, other);
+    if (import_binary (ring, clause, source, true))
+      return true;
+  }
+  return false;
+}
+
 bool import_shared (struct ring *ring) {
+  if (ring->ruler->exchange.segment && import_exchanged (ring))
+    return true;
   if (!ring->pool)
     return false;
+  if (ring->options.telemetry) {
+    publish_telemetry_conflicts (ring);
+    check_telemetry_request (ring);
+  }
   if (import_units (ring))
     return true;
+  if (ring->ruler->store.chunks && import_stored_binaries (ring))
+    return true;
   if (ring->options.limit_import_rate) {
     if (!ring->import_after_propagation_and_conflict)
       return false;
     ring->import_after_propagation_and_conflict = false;
   }
 
-  struct ring *src = random_other_ring (ring);
+  if (ring->options.import_batch)
+    return import_batch (ring);
+
+  struct ring *src = ring->options.import_feedback
+                         ? select_useful_source (ring)
+                         : random_other_ring (ring);
   struct pool *pool = src->pool + ring->id;
 
   struct bucket *start = pool->bucket;
-  struct bucket *end = start + SIZE_POOL;
+  unsigned capacity =
+      atomic_load_explicit (&pool->capacity, memory_order_relaxed);
+  struct bucket *end = start + capacity;
   struct bucket *best = 0;
 
   uint64_t best_redundancy = MAX_REDUNDANCY;
@@ -434,15 +685,16 @@ bool import_shared (struct ring *ring) {
   if (best) {
     LOG ("import from ring %u bucket %zu with redundancy [%u:%u]", src->id,
          best - start, LOG_REDUNDANCY (best_redundancy));
-    atomic_uintptr_t *p = &best->shared;
-    clause = (struct clause *) atomic_exchange (p, 0);
-    assert (clause);
+    clause = take_shared_clause (ring, src->id, pool, best);
+    if (!clause) {
+      LOG ("import from ring %u bucket %zu failed (flushed)", src->id,
+           best - start);
+      return false;
+    }
   } else {
     LOG ("import from ring %u failed (nothing to import)", src->id);
     return false;
   }
 
-  if (is_binary_pointer (clause))
-    return import_binary (ring, clause);
-  return import_large_clause (ring, clause);
+  return import_clause (ring, clause, src->id);
 }
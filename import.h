@@ -5,5 +5,6 @@
 
 struct ring;
 bool import_shared (struct ring *);
+void update_import_feedback (struct ring *);
 
 #endif
@@ -0,0 +1,726 @@
+#define _DEFAULT_SOURCE
+#include "network.h"
+#include "allocate.h"
+#include "exchange.h"
+#include "message.h"
+#include "ruler.h"
+#include "system.h"
+#include "utilities.h"
+#include "witness.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Each message starts with a header of six bytes, the message type, the
+// number of times the message has been relayed and the length of the
+// payload as 32-bit little endian number.
+
+#define NETWORK_HEADER 6
+#define NETWORK_MAX_MESSAGE (1u << 28)
+#define NETWORK_MAX_BATCH (1u << 16)
+#define NETWORK_MAX_QUEUED (1u << 24)
+#define NETWORK_CONNECT_TIMEOUT 100
+
+#define HELLO_MESSAGE 'h'
+#define CLAUSES_MESSAGE 'c'
+#define RESULT_MESSAGE 'r'
+
+/*------------------------------------------------------------------------*/
+
+static void push_bytes (struct buffer *buffer, const void *bytes,
+                        size_t size) {
+  const char *p = bytes, *end = p + size;
+  while (p != end)
+    PUSH (*buffer, *p++);
+}
+
+static void push_variable_bytes (struct buffer *buffer, unsigned value) {
+  while (value & ~127u) {
+    char ch = (value & 0x7f) | 128;
+    PUSH (*buffer, ch);
+    value >>= 7;
+  }
+  char ch = value;
+  PUSH (*buffer, ch);
+}
+
+static bool pop_variable_bytes (const unsigned char **p,
+                                const unsigned char *end,
+                                unsigned *res) {
+  unsigned value = 0;
+  for (unsigned shift = 0; shift < 32; shift += 7) {
+    if (*p == end)
+      return false;
+    unsigned ch = *(*p)++;
+    value |= (ch & 0x7f) << shift;
+    if (!(ch & 128)) {
+      *res = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void push_header (struct buffer *buffer, char type, char hops,
+                         size_t length) {
+  assert (length < NETWORK_MAX_MESSAGE);
+  char header[NETWORK_HEADER] = {type, hops};
+  for (unsigned i = 0; i != 4; i++)
+    header[2 + i] = (length >> (8 * i)) & 0xff;
+  push_bytes (buffer, header, sizeof header);
+}
+
+/*------------------------------------------------------------------------*/
+
+// Literals of a clause are encoded as '2 * (variable - 1) + sign', sorted
+// and then written as first value followed by (positive) differences.
+
+static unsigned encode_literal (int literal) {
+  if (literal < 0)
+    return 2 * (-(unsigned) literal - 1) + 1;
+  return 2 * ((unsigned) literal - 1);
+}
+
+static void encode_record (struct buffer *buffer,
+                           struct exchange_record *record) {
+  unsigned size = record->size;
+  unsigned encoded[SIZE_EXCHANGE_LITERALS];
+  for (unsigned i = 0; i != size; i++) {
+    unsigned lit = encode_literal (record->literals[i]), j = i;
+    while (j && encoded[j - 1] > lit) {
+      encoded[j] = encoded[j - 1];
+      j--;
+    }
+    encoded[j] = lit;
+  }
+  push_variable_bytes (buffer, size);
+  push_variable_bytes (buffer, record->glue);
+  unsigned prev = 0;
+  for (unsigned i = 0; i != size; i++) {
+    push_variable_bytes (buffer, encoded[i] - prev);
+    prev = encoded[i];
+  }
+}
+
+static bool decode_record (const unsigned char **p,
+                           const unsigned char *end, unsigned variables,
+                           struct exchange_record *record) {
+  unsigned size, glue;
+  if (!pop_variable_bytes (p, end, &size))
+    return false;
+  if (!size || size > SIZE_EXCHANGE_LITERALS)
+    return false;
+  if (!pop_variable_bytes (p, end, &glue))
+    return false;
+  record->size = size;
+  record->glue = glue < MAX_GLUE ? glue : MAX_GLUE;
+  unsigned lit = 0;
+  for (unsigned i = 0; i != size; i++) {
+    unsigned delta;
+    if (!pop_variable_bytes (p, end, &delta))
+      return false;
+    if (i && (!delta || (lit >> 1) == ((lit + delta) >> 1)))
+      return false;
+    if (delta >= 2 * variables - lit)
+      return false;
+    lit += delta;
+    int idx = (lit >> 1) + 1;
+    record->literals[i] = (lit & 1) ? -idx : idx;
+  }
+  return true;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void configure_socket (int fd) {
+  int flags = fcntl (fd, F_GETFL, 0);
+  if (flags < 0 || fcntl (fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    fatal_error ("can not make socket non-blocking");
+  int one = 1;
+  (void) setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+#ifdef SO_NOSIGPIPE
+  (void) setsockopt (fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof one);
+#endif
+}
+
+static void new_peer (struct ruler *ruler, int fd, bool accepted,
+                      const char *name) {
+  configure_socket (fd);
+  struct peer *peer = allocate_and_clear_block (sizeof *peer);
+  peer->fd = fd;
+  peer->accepted = accepted;
+  peer->name = strdup (name);
+  struct network *network = &ruler->network;
+  PUSH (network->peers, peer);
+  char payload[12];
+  uint64_t formula = ruler->exchange.formula;
+  for (unsigned i = 0; i != 4; i++)
+    payload[i] = (ruler->size >> (8 * i)) & 0xff;
+  for (unsigned i = 0; i != 8; i++)
+    payload[4 + i] = (formula >> (8 * i)) & 0xff;
+  push_header (&peer->out, HELLO_MESSAGE, 0, sizeof payload);
+  push_bytes (&peer->out, payload, sizeof payload);
+  message (0, "%s peer '%s'", accepted ? "accepted" : "connected to",
+           name);
+}
+
+static void delete_peer (struct peer *peer) {
+  if (peer->fd >= 0)
+    close (peer->fd);
+  RELEASE (peer->in);
+  RELEASE (peer->out);
+  free (peer->name);
+  free (peer);
+}
+
+static void disconnect_peer (struct peer *peer, const char *reason) {
+  if (peer->fd < 0)
+    return;
+  message (0, "disconnecting peer '%s' (%s)", peer->name, reason);
+  close (peer->fd);
+  peer->fd = -1;
+  CLEAR (peer->out);
+}
+
+static void listen_for_peers (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  unsigned port = ruler->options.listen;
+  int fd = socket (AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    fatal_error ("can not create listening socket");
+  int one = 1;
+  (void) setsockopt (fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+  struct sockaddr_in address;
+  memset (&address, 0, sizeof address);
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl (INADDR_ANY);
+  address.sin_port = htons (port);
+  if (bind (fd, (struct sockaddr *) &address, sizeof address))
+    fatal_error ("can not bind to port %u", port);
+  if (listen (fd, 64))
+    fatal_error ("can not listen on port %u", port);
+  configure_socket (fd);
+  network->listener = fd;
+  message (0, "listening for peers on port %u", port);
+}
+
+static void accept_peers (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  for (;;) {
+    struct sockaddr_storage address;
+    socklen_t length = sizeof address;
+    int fd =
+        accept (network->listener, (struct sockaddr *) &address, &length);
+    if (fd < 0)
+      break;
+    char host[NI_MAXHOST], service[NI_MAXSERV];
+    char name[sizeof host + sizeof service];
+    if (getnameinfo ((struct sockaddr *) &address, length, host,
+                     sizeof host, service, sizeof service,
+                     NI_NUMERICHOST | NI_NUMERICSERV))
+      strcpy (name, "<unknown>");
+    else
+      snprintf (name, sizeof name, "%s:%s", host, service);
+    new_peer (ruler, fd, true, name);
+  }
+}
+
+// Connecting is non-blocking and bounded by a timeout, since otherwise
+// a host dropping connection requests would block the network thread
+// (and thus clause sharing and termination) for the full TCP timeout.
+
+static bool connect_with_timeout (int fd, struct addrinfo *address) {
+  int flags = fcntl (fd, F_GETFL, 0);
+  if (flags < 0 || fcntl (fd, F_SETFL, flags | O_NONBLOCK) < 0)
+    return false;
+  if (!connect (fd, address->ai_addr, address->ai_addrlen))
+    return true;
+  if (errno != EINPROGRESS)
+    return false;
+  struct pollfd pollfd = {.fd = fd, .events = POLLOUT};
+  if (poll (&pollfd, 1, NETWORK_CONNECT_TIMEOUT) <= 0)
+    return false;
+  int error = 0;
+  socklen_t length = sizeof error;
+  if (getsockopt (fd, SOL_SOCKET, SO_ERROR, &error, &length))
+    return false;
+  return !error;
+}
+
+static int connect_to_target (const char *target) {
+  const char *colon = strrchr (target, ':');
+  assert (colon);
+  size_t length = colon - target;
+  char *host = allocate_block (length + 1);
+  memcpy (host, target, length);
+  host[length] = 0;
+  struct addrinfo hints, *addresses;
+  memset (&hints, 0, sizeof hints);
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  int res = -1;
+  if (!getaddrinfo (host, colon + 1, &hints, &addresses)) {
+    for (struct addrinfo *a = addresses; res < 0 && a; a = a->ai_next) {
+      res = socket (a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (res >= 0 && !connect_with_timeout (res, a)) {
+        close (res);
+        res = -1;
+      }
+    }
+    freeaddrinfo (addresses);
+  }
+  free (host);
+  return res;
+}
+
+// Targets which could not be connected yet are retried in every round,
+// since those peers might still be parsing and simplifying the formula.
+
+static void connect_to_peers (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  char *targets = network->targets;
+  if (!targets)
+    return;
+  char *remaining = allocate_block (strlen (targets) + 1);
+  char *q = remaining;
+  for (char *p = targets, *next; *p; p = next) {
+    char *comma = strchr (p, ',');
+    if (comma) {
+      *comma = 0;
+      next = comma + 1;
+    } else
+      next = p + strlen (p);
+    int fd = connect_to_target (p);
+    if (fd >= 0) {
+      new_peer (ruler, fd, false, p);
+      continue;
+    }
+    if (q != remaining)
+      *q++ = ',';
+    strcpy (q, p);
+    q += strlen (p);
+  }
+  *q = 0;
+  free (targets);
+  if (!*remaining) {
+    free (remaining);
+    remaining = 0;
+  }
+  network->targets = remaining;
+}
+
+/*------------------------------------------------------------------------*/
+
+static void send_message (struct ruler *ruler, struct peer *except,
+                          char type, char hops, const void *payload,
+                          size_t length) {
+  struct network *network = &ruler->network;
+  for (all_pointers_on_stack (struct peer, peer, network->peers)) {
+    if (peer == except || peer->fd < 0 || !peer->greeted ||
+        peer->closing)
+      continue;
+    if (SIZE (peer->out) > NETWORK_MAX_QUEUED) {
+      network->statistics.dropped++;
+      continue;
+    }
+    push_header (&peer->out, type, hops, length);
+    push_bytes (&peer->out, payload, length);
+  }
+}
+
+static void send_batch (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  struct exchange *exchange = &ruler->exchange;
+  struct network_statistics *statistics = &network->statistics;
+  unsigned glue_limit = ruler->options.network_glue;
+  struct exchange_record record;
+  uint64_t lost = 0;
+  CLEAR (network->batch);
+  while (SIZE (network->batch) < NETWORK_MAX_BATCH &&
+         read_exchange_record (exchange->segment, &network->position,
+                               &record, &lost)) {
+    if (record.process != exchange->process)
+      continue;
+    if (record.size > 2 && record.glue > glue_limit)
+      continue;
+    encode_record (&network->batch, &record);
+    statistics->clauses.sent++;
+  }
+  if (EMPTY (network->batch))
+    return;
+  statistics->batches++;
+  send_message (ruler, 0, CLAUSES_MESSAGE, 0, network->batch.begin,
+                SIZE (network->batch));
+}
+
+static void send_result (struct ruler *ruler, int status,
+                         signed char *witness) {
+  struct network *network = &ruler->network;
+  struct buffer *payload = &network->batch;
+  CLEAR (*payload);
+  PUSH (*payload, (char) status);
+  if (status == 10) {
+    unsigned char byte = 0;
+    for (unsigned idx = 0; idx != ruler->size; idx++) {
+      if (witness[LIT (idx)] > 0)
+        byte |= 1u << (idx & 7);
+      if ((idx & 7) == 7 || idx + 1 == ruler->size) {
+        PUSH (*payload, (char) byte);
+        byte = 0;
+      }
+    }
+  }
+  send_message (ruler, 0, RESULT_MESSAGE, 0, payload->begin,
+                SIZE (*payload));
+}
+
+/*------------------------------------------------------------------------*/
+
+static bool receive_hello (struct ruler *ruler, struct peer *peer,
+                           const unsigned char *payload, size_t length) {
+  if (length != 12)
+    return false;
+  unsigned variables = 0;
+  for (unsigned i = 0; i != 4; i++)
+    variables |= (unsigned) payload[i] << (8 * i);
+  if (variables != ruler->size) {
+    message (0, "peer '%s' has %u variables (but formula has %u)",
+             peer->name, variables, ruler->size);
+    return false;
+  }
+  uint64_t formula = 0;
+  for (unsigned i = 0; i != 8; i++)
+    formula |= (uint64_t) payload[4 + i] << (8 * i);
+  if (formula != ruler->exchange.formula) {
+    message (0, "peer '%s' has a different formula", peer->name);
+    return false;
+  }
+  peer->greeted = true;
+  return true;
+}
+
+static bool receive_clauses (struct ruler *ruler,
+                             const unsigned char *payload, size_t length) {
+  struct network *network = &ruler->network;
+  struct exchange_segment *segment = ruler->exchange.segment;
+  const unsigned char *p = payload, *end = payload + length;
+  struct exchange_record record;
+  record.process = 0;
+  while (p != end) {
+    if (!decode_record (&p, end, ruler->size, &record))
+      return false;
+    write_exchange_record (segment, &record);
+    network->statistics.clauses.received++;
+  }
+  return true;
+}
+
+// Results received from peers are only trusted if the hash of their
+// formula matched in the hello message.  Witnesses are further checked
+// against the parsed clauses and otherwise ignored (and the peer is
+// disconnected).
+
+static bool receive_result (struct ruler *ruler, struct peer *peer,
+                            const unsigned char *payload, size_t length) {
+  struct network *network = &ruler->network;
+  if (!length)
+    return false;
+  int status = payload[0];
+  if (status != 10 && status != 20)
+    return false;
+  if (status == 10 && length != 1 + (ruler->size + 7) / 8)
+    return false;
+  if (network->status)
+    return true;
+  if (status == 10) {
+    signed char *witness = allocate_array (2 * ruler->size, 1);
+    for (unsigned idx = 0; idx != ruler->size; idx++) {
+      bool bit = (payload[1 + idx / 8] >> (idx & 7)) & 1;
+      witness[LIT (idx)] = bit ? 1 : -1;
+      witness[NOT (LIT (idx))] = bit ? -1 : 1;
+    }
+    if (!satisfies_original (witness, ruler->original)) {
+      message (0, "peer '%s' sent a witness not satisfying the formula",
+               peer->name);
+      free (witness);
+      return false;
+    }
+    network->witness = witness;
+  }
+  network->status = status;
+  message (0, "peer '%s' determined result %d", peer->name, status);
+  set_terminate (ruler, 0);
+  return true;
+}
+
+static bool receive_message (struct ruler *ruler, struct peer *peer,
+                             const unsigned char *message) {
+  char type = message[0], hops = message[1];
+  size_t length = 0;
+  for (unsigned i = 0; i != 4; i++)
+    length |= (size_t) message[2 + i] << (8 * i);
+  const unsigned char *payload = message + NETWORK_HEADER;
+  if (type == HELLO_MESSAGE)
+    return !peer->greeted && receive_hello (ruler, peer, payload, length);
+  if (!peer->greeted)
+    return false;
+  bool res;
+  if (type == CLAUSES_MESSAGE)
+    res = receive_clauses (ruler, payload, length);
+  else if (type == RESULT_MESSAGE)
+    res = receive_result (ruler, peer, payload, length);
+  else
+    res = false;
+  if (res && !hops && peer->accepted) {
+    send_message (ruler, peer, type, 1, payload, length);
+    ruler->network.statistics.relayed++;
+  }
+  return res;
+}
+
+// A peer might send its result and close the connection right away.
+// Therefore all complete messages received before the end-of-file are
+// processed before the peer is disconnected.
+
+static void receive_from_peer (struct ruler *ruler, struct peer *peer) {
+  struct network_statistics *statistics = &ruler->network.statistics;
+  struct buffer *in = &peer->in;
+  bool closed = false;
+  for (;;) {
+    if (CAPACITY (*in) - SIZE (*in) < 4096) {
+      size_t size = SIZE (*in);
+      size_t capacity = 2 * CAPACITY (*in) + 4096;
+      in->begin = reallocate_block (in->begin, capacity);
+      in->end = in->begin + size;
+      in->allocated = in->begin + capacity;
+    }
+    ssize_t bytes = recv (peer->fd, in->end, in->allocated - in->end, 0);
+    if (!bytes) {
+      closed = true;
+      break;
+    }
+    if (bytes < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        disconnect_peer (peer, "receive failed");
+      break;
+    }
+    in->end += bytes;
+    statistics->bytes.received += bytes;
+  }
+  const unsigned char *p = (unsigned char *) in->begin;
+  const unsigned char *end = (unsigned char *) in->end;
+  while (end - p >= NETWORK_HEADER) {
+    size_t length = 0;
+    for (unsigned i = 0; i != 4; i++)
+      length |= (size_t) p[2 + i] << (8 * i);
+    if (length >= NETWORK_MAX_MESSAGE) {
+      disconnect_peer (peer, "invalid message length");
+      return;
+    }
+    if ((size_t) (end - p) < NETWORK_HEADER + length)
+      break;
+    if (!receive_message (ruler, peer, p)) {
+      disconnect_peer (peer, "invalid message");
+      return;
+    }
+    p += NETWORK_HEADER + length;
+  }
+  size_t remaining = end - p;
+  memmove (in->begin, p, remaining);
+  in->end = in->begin + remaining;
+  if (closed)
+    disconnect_peer (peer, "closed");
+}
+
+static void send_to_peer (struct ruler *ruler, struct peer *peer) {
+  struct network_statistics *statistics = &ruler->network.statistics;
+  struct buffer *out = &peer->out;
+  char *p = out->begin;
+  while (p != out->end) {
+    ssize_t bytes = send (peer->fd, p, out->end - p, MSG_NOSIGNAL);
+    if (bytes < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        disconnect_peer (peer, "send failed");
+      break;
+    }
+    p += bytes;
+    statistics->bytes.sent += bytes;
+  }
+  if (peer->fd < 0)
+    return;
+  size_t remaining = out->end - p;
+  memmove (out->begin, p, remaining);
+  out->end = out->begin + remaining;
+}
+
+static void poll_peers (struct ruler *ruler, int timeout) {
+  struct network *network = &ruler->network;
+  size_t size = SIZE (network->peers) + 1;
+  struct pollfd *fds = allocate_array (size, sizeof *fds);
+  struct pollfd *q = fds;
+  if (network->listener >= 0) {
+    q->fd = network->listener;
+    q->events = POLLIN;
+    q++;
+  }
+  for (all_pointers_on_stack (struct peer, peer, network->peers)) {
+    if (peer->fd < 0)
+      continue;
+    q->fd = peer->fd;
+    q->events = POLLIN;
+    if (!EMPTY (peer->out))
+      q->events |= POLLOUT;
+    q++;
+  }
+  int ready = poll (fds, q - fds, timeout);
+  free (fds);
+  if (ready <= 0)
+    return;
+  if (network->listener >= 0)
+    accept_peers (ruler);
+  for (all_pointers_on_stack (struct peer, peer, network->peers)) {
+    if (peer->fd >= 0)
+      receive_from_peer (ruler, peer);
+    if (peer->fd >= 0 && !EMPTY (peer->out))
+      send_to_peer (ruler, peer);
+  }
+}
+
+static void *network_routine (void *ptr) {
+  struct ruler *ruler = ptr;
+  struct network *network = &ruler->network;
+  int interval = ruler->options.network_interval;
+  while (!ruler->terminate &&
+         !atomic_load_explicit (&network->stop, memory_order_relaxed)) {
+    connect_to_peers (ruler);
+    send_batch (ruler);
+    poll_peers (ruler, interval);
+  }
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+void start_network (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  assert (!network->running);
+  assert (ruler->exchange.segment);
+  network->listener = -1;
+  if (ruler->options.listen)
+    listen_for_peers (ruler);
+  if (ruler->options.connect)
+    network->targets = strdup (ruler->options.connect);
+  network->position =
+      atomic_load (&ruler->exchange.segment->head);
+  network->started = current_time ();
+  if (pthread_create (&network->thread, 0, network_routine, ruler))
+    fatal_error ("failed to create network thread");
+  network->running = true;
+}
+
+void stop_network (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  if (!network->running)
+    return;
+  atomic_store (&network->stop, true);
+  if (pthread_join (network->thread, 0))
+    fatal_error ("failed to join network thread");
+  network->running = false;
+}
+
+// Sends the result to all peers (unless it was received from one) or
+// otherwise adopts the result of a peer, then closes all connections.
+// Closing a socket with unread data makes the kernel reset the connection
+// and discard data not yet read by the peer.  Thus the connections are
+// only shut down for writing first and closed after the peers did so.
+
+int finish_network (struct ruler *ruler, int status,
+                    signed char **witness) {
+  struct network *network = &ruler->network;
+  if (!network->started)
+    return status;
+  assert (!network->running);
+  if (!status && network->status) {
+    status = network->status;
+    *witness = network->witness;
+    network->witness = 0;
+  } else if (status && !network->status)
+    send_result (ruler, status, *witness);
+  double deadline = current_time () + 1;
+  bool pending = true;
+  while (pending && current_time () < deadline) {
+    pending = false;
+    for (all_pointers_on_stack (struct peer, peer, network->peers))
+      if (peer->fd >= 0 && !EMPTY (peer->out))
+        pending = true;
+    if (pending)
+      poll_peers (ruler, 10);
+  }
+  for (all_pointers_on_stack (struct peer, peer, network->peers))
+    if (peer->fd >= 0) {
+      (void) shutdown (peer->fd, SHUT_WR);
+      peer->closing = true;
+      CLEAR (peer->out);
+    }
+  bool open = true;
+  while (open && current_time () < deadline) {
+    open = false;
+    for (all_pointers_on_stack (struct peer, peer, network->peers))
+      if (peer->fd >= 0)
+        open = true;
+    if (open)
+      poll_peers (ruler, 10);
+  }
+  for (all_pointers_on_stack (struct peer, peer, network->peers))
+    delete_peer (peer);
+  RELEASE (network->peers);
+  RELEASE (network->batch);
+  if (network->listener >= 0)
+    close (network->listener);
+  network->listener = -1;
+  free (network->targets);
+  free (network->witness);
+  network->targets = 0;
+  network->witness = 0;
+  return status;
+}
+
+void print_network_statistics (struct ruler *ruler) {
+  struct network *network = &ruler->network;
+  if (!network->started)
+    return;
+  struct network_statistics *s = &network->statistics;
+  double seconds = current_time () - network->started;
+  printf ("c %-22s %17" PRIu64 " %13.2f clauses per batch\n",
+          "network-batches:", s->batches,
+          average (s->clauses.sent, s->batches));
+  printf ("c %-22s %17" PRIu64 " %13.2f per second\n",
+          "network-sent:", s->clauses.sent,
+          average (s->clauses.sent, seconds));
+  printf ("c %-22s %17" PRIu64 " %13.2f per second\n",
+          "network-received:", s->clauses.received,
+          average (s->clauses.received, seconds));
+  printf ("c %-22s %17" PRIu64 " %13.2f bytes per clause\n",
+          "  bytes-sent:", s->bytes.sent,
+          average (s->bytes.sent, s->clauses.sent));
+  printf ("c %-22s %17" PRIu64 " %13.2f bytes per clause\n",
+          "  bytes-received:", s->bytes.received,
+          average (s->bytes.received, s->clauses.received));
+  printf ("c %-22s %17" PRIu64 " %13.2f per batch\n",
+          "  relayed:", s->relayed, average (s->relayed, s->batches));
+  printf ("c %-22s %17" PRIu64 " %13.2f per batch\n",
+          "  dropped:", s->dropped, average (s->dropped, s->batches));
+}
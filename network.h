@@ -0,0 +1,74 @@
+#ifndef _network_h_INCLUDED
+#define _network_h_INCLUDED
+
+#include "stack.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// In distributed mode every node runs the usual portfolio of rings and one
+// additional network thread, which is connected to the peer nodes over TCP.
+// Connected nodes first exchange the number of variables and the hash of
+// the parsed formula (see 'exchange.h') and disconnect if they differ.
+// Nodes either listen for peers ('--listen=<port>') or connect to them
+// ('--connect=<host>:<port>,...') or both.  The network thread collects the
+// units and clauses written by the rings of its own process to the exchange
+// buffer (see 'exchange.h', which without '--exchange' is private to the
+// process), keeps those with small glue, and sends them in batches to all
+// peers, in the original variable numbering and compressed by delta and
+// variable byte encoding of sorted literals.  Received clauses are written
+// to the exchange buffer and thus imported by the local rings.  A node
+// relays batches received on connections it accepted to its other peers
+// once, so a star of workers connected to one leader shares clauses among
+// all of them.  If a node determines the result it sends it (with the
+// witness if satisfiable) to all peers, which then stop and report that
+// result.
+
+struct ruler;
+
+struct peer {
+  int fd;
+  bool accepted;
+  bool greeted;
+  bool closing;
+  char *name;
+  struct buffer in, out;
+};
+
+struct peers {
+  struct peer **begin, **end, **allocated;
+};
+
+struct network_statistics {
+  uint64_t batches;
+  uint64_t dropped;
+  uint64_t relayed;
+  struct {
+    uint64_t sent;
+    uint64_t received;
+  } bytes, clauses;
+};
+
+struct network {
+  bool running;
+  atomic_bool stop;
+  int listener;
+  int status;
+  signed char *witness;
+  char *targets;
+  uint64_t position;
+  double started;
+  pthread_t thread;
+  struct buffer batch;
+  struct peers peers;
+  struct network_statistics statistics;
+};
+
+void start_network (struct ruler *);
+void stop_network (struct ruler *);
+int finish_network (struct ruler *, int status, signed char **witness);
+void print_network_statistics (struct ruler *);
+
+#endif
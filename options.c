@@ -266,6 +266,34 @@ void parse_options (int argc, char **argv, struct options *opts) {
         die ("invalid zero argument in '%s'", opt);
       if (opts->threads > MAX_THREADS)
         die ("invalid argument in '%s' (maximum %u)", opt, MAX_THREADS);
+    } else if (!strncmp (opt, "--connect=", 10)) {
+      if (opts->connect)
+        die ("multiple '--connect=%s' and '%s'", opts->connect, opt);
+      if (!opt[10])
+        die ("empty peer list in '%s'", opt);
+      for (const char *p = opt + 10, *end; *p; p = end + !!*end) {
+        end = strchr (p, ',');
+        if (!end)
+          end = p + strlen (p);
+        const char *colon = p;
+        while (colon != end && *colon != ':')
+          colon++;
+        if (colon == p || colon == end || colon + 1 == end)
+          die ("invalid peer in '%s' (expected '<host>:<port>')", opt);
+      }
+      opts->connect = opt + 10;
+    } else if (!strncmp (opt, "--exchange=", 11)) {
+      if (opts->exchange)
+        die ("multiple '--exchange=%s' and '%s'", opts->exchange, opt);
+      if (!opt[11])
+        die ("empty shared memory name in '%s'", opt);
+      opts->exchange = opt + 11;
+    } else if (!strncmp (opt, "--telemetry=", 12)) {
+      if (opts->telemetry)
+        die ("multiple '--telemetry=%s' and '%s'", opts->telemetry, opt);
+      if (!opt[12])
+        die ("empty file name in '%s'", opt);
+      opts->telemetry = opt + 12;
     } else if ((arg = match_and_find_option_argument (opt, "time"))) {
       if (opts->seconds)
         die ("multiple '--time=%u' and '%s'", opts->seconds, opt);
@@ -345,6 +373,12 @@ void parse_options (int argc, char **argv, struct options *opts) {
   if (!opts->threads)
     opts->threads = 1;
 
+  if (opts->exchange && opts->proof.file)
+    die ("can not combine '--exchange=%s' with proof tracing",
+         opts->exchange);
+  if ((opts->listen || opts->connect) && opts->proof.file)
+    die ("can not combine distributed mode with proof tracing");
+
 #ifndef QUIET
   if (opts->threads <= 10)
     prefix_format = "c%-1u ";
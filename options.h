@@ -18,6 +18,9 @@
 #define MAX_SCORE 1e150
 #define MAX_THREADS (1u << 16)
 
+#define MIN_POOL 2
+#define SIZE_POOL 32
+
 #define CACHE_LINE_SIZE 128
 
 /*------------------------------------------------------------------------*/
@@ -57,28 +60,43 @@
 #define INF INT_MAX
 
 #define OPTIONS \
+  OPTION (bool, adapt_pools, 1, 0, 1, "adapt capacity of clause export pools") \
   OPTION (unsigned, backjump_limit, 100, 0, INF, "number of levels jumped over") \
   OPTION (bool, binary, 1, 0, 1, "use binary DRAT proof format") \
+  OPTION (bool, binary_store, 0, 0, 1, "share learned binary clauses through global store") \
   OPTION (bool, bump_reasons, 1, 0, 1, "bump reason side literals") \
+  OPTION (bool, bva, 0, 0, 1, "bounded variable addition initially") \
+  OPTION (unsigned, bva_ticks, 10, 0, INF, "variable addition ticks limit in millions") \
   OPTION (bool, calculate_tiers, 1, 0, 1, "use calculated tier limits") \
   OPTION (unsigned, clause_size_limit, 100, 3, 10000, "during simplification") \
   OPTION (bool, chronological, 1, 0, 1, "enable chronological backtracking") \
   OPTION (bool, deduplicate, 1, 0, 1, "remove duplicated binary clauses") \
   OPTION (unsigned, eagerly_subsume, 4, 0, 4, "eagerly subsumed last learned clauses") \
   OPTION (bool, eliminate, 1, 0, 1, "bounded variable elimination") \
-  OPTION (unsigned, export, 3, 1, 3, "export to 1=one, 2=log, 3=all threads") \
+  OPTION (unsigned, defer_dereferences, 256, 0, 1u << 16, "batch size of deferred shared clause dereferences (0=disable)") \
+  OPTION (unsigned, export, 3, 1, 4, "export to 1=one, 2=log, 3=all threads, 4=topology") \
+  OPTION (unsigned, export_filter, 16, 0, 30, "log2 size of exported clause filter (0=disable)") \
   OPTION (unsigned, eliminate_bound, 16, 0, 1024, "additionally added clause margin") \
+  OPTION (unsigned, eliminate_threads, 16, 1, MAX_THREADS, "maximum number of variable elimination threads") \
   OPTION (bool, fail, 1, 0, 1, "failed literal probing") \
   OPTION (bool, focus_initially, 1, 0, 1, "start with focus mode initially") \
   OPTION (bool, force_phase, 0, 0, 1, "force phase (same phase for all solvers") \
   OPTION (bool, force, 0, 0, 1, "force relaxed parsing and proof writing") \
+  OPTION (bool, import_feedback, 0, 0, 1, "weight and throttle sources by usefulness") \
+  OPTION (unsigned, import_batch, 0, 0, INF, "batched import tick budget (0=single clause)") \
   OPTION (unsigned, increase_imported_glue, 0, 0, 2, "increase glue imported glue (2=max)") \
   OPTION (bool, limit_import_rate, 1, 0, 1, "adapt import to learned clause rate") \
+  OPTION (unsigned, listen, 0, 0, 65535, "listen on TCP port for peers (0=disable)") \
   OPTION (bool, minimize, 1, 0, 1, "minimize learned clauses") \
   OPTION (unsigned, minimize_depth, 1000, 1, INF, "recursive clause minimization depth") \
+  OPTION (unsigned, network_glue, 2, 0, MAX_GLUE, "glue limit of clauses sent to peers") \
+  OPTION (unsigned, network_interval, 10, 1, 1000, "milliseconds between batches sent to peers") \
   OPTION (unsigned, occurrence_limit, 1000, 0, INF, "literal occurrence limit in simplification") \
   OPTION (bool, phase, 1, 0, 1, "initial decision phase") \
+  OPTION (unsigned, pool_capacity, 8, MIN_POOL, SIZE_POOL, "initial clause export pool capacity") \
+  OPTION (bool, pin, 0, 0, 1, "pin threads to CPUs ordered by topology") \
   OPTION (bool, portfolio, 1, 0, 1, "threads use different strategies") \
+  OPTION (unsigned, prefetch, 0, 0, 64, "watch prefetch distance (0=disable)") \
   OPTION (bool, probe, 1, 0, 1, "enable probing based inprocessing") \
   OPTION (unsigned, probe_interval, 100, 1, INF, "probing base conflict interval") \
   OPTION (bool, random_decisions, 1, 0, 1, "random decisions") \
@@ -94,6 +112,7 @@
   OPTION (bool, share_learned, 1, 0, 1, "export and import learned clauses") \
   OPTION (bool, share_by_size, 0, 0, 1, "prioritize shared clauses by size and not glue") \
   OPTION (bool, shrink, 1, 0, 1, "shrink (glue 1) learned clauses") \
+  OPTION (bool, simd, 1, 0, 1, "vectorized replacement literal search") \
   OPTION (bool, simplify, 1, 0, 1, "elimination, subsumption and substitution") \
   OPTION (unsigned, simplify_boost, 1, 0, 1, "additional initial boost to simplification") \
   OPTION (unsigned, simplify_boost_rounds, 4, 2, INF, "initial increase rounds limit") \
@@ -108,13 +127,16 @@
   OPTION (bool, substitute, 1, 0, 1, "equivalent literal substitution") \
   OPTION (bool, subsume, 1, 0, 1, "clause subsumption and strengthening") \
   OPTION (bool, subsume_imported, 1, 0, 1, "subsume imported clauses") \
+  OPTION (unsigned, subsume_threads, 16, 1, MAX_THREADS, "maximum number of forward subsumption threads") \
   OPTION (unsigned, subsume_ticks, 20, 0, INF, "subsumption ticks limit in millions") \
   OPTION (unsigned, target_phases, 1, 0, 2, "target phases (2 = in focused mode too)") \
+  OPTION (bool, trail_saving, 0, 0, 1, "save and replay backtracked trail") \
   OPTION (bool, vivify, 1, 0, 1, "vivification of redundant clauses") \
   OPTION (bool, vivify_export, 1, 0, 1, "export vivified clauses") \
   OPTION (bool, walk_initially, 0, 0, 1, "local search initially") \
   OPTION (bool, warm_up_walking, 1, 0, 1, "unit propagation warm-up of local search") \
-  OPTION (bool, witness, 1, 0, 1, "print satisfying assignment")
+  OPTION (bool, witness, 1, 0, 1, "print satisfying assignment") \
+  OPTION (unsigned, xor_arity, 0, 0, 8, "maximum arity of extracted XOR gates (0=disable)")
 
 // clang-format on
 
@@ -124,6 +146,9 @@ struct options {
   unsigned threads;
   unsigned optimize;
   bool summarize;
+  const char *connect;
+  const char *exchange;
+  const char *telemetry;
 
 #define OPTION(TYPE, NAME, DEFAULT, MIN, MAX, DESCRIPTION) TYPE NAME;
   OPTIONS
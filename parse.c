@@ -139,6 +139,15 @@ void parse_dimacs_header (struct options *options, int *variables_ptr,
   *clauses_ptr = clauses;
 }
 
+// The hash of the parsed literals identifies the formula of processes
+// sharing clauses through an exchange segment (see 'exchange.h').
+
+static uint64_t hash_parsed_literal (uint64_t hash, int lit) {
+  hash += (unsigned) lit;
+  hash *= 0x9e3779b97f4a7c15ull;
+  return hash ^ (hash >> 32);
+}
+
 void parse_dimacs_body (struct ruler *ruler, int variables, int expected) {
 #ifndef QUIET
   double start_parsing = START (ruler, parse);
@@ -151,9 +160,8 @@ void parse_dimacs_body (struct ruler *ruler, int variables, int expected) {
   struct unsigneds clause;
   INIT (clause);
   int signed_lit = 0, parsed = 0;
-#ifndef NDEBUG
+  uint64_t hash = 0;
   struct unsigneds *original = ruler->original;
-#endif
   bool trivial = false;
   for (;;) {
     int ch = next_char (dimacs);
@@ -182,15 +190,15 @@ void parse_dimacs_body (struct ruler *ruler, int variables, int expected) {
       parse_error (dimacs, "too many clauses");
     if (ch != 'c' && ch != ' ' && ch != '\t' && ch != '\n' && ch != EOF)
       parse_error (dimacs, "invalid character after '%d'", signed_lit);
+    hash = hash_parsed_literal (hash, signed_lit);
     if (signed_lit) {
       unsigned idx = abs (signed_lit) - 1;
       assert (idx < (unsigned) variables);
       signed char sign = (signed_lit < 0) ? -1 : 1;
       signed char mark = marked[idx];
       unsigned unsigned_lit = 2 * idx + (sign < 0);
-#ifndef NDEBUG
-      PUSH (*original, unsigned_lit);
-#endif
+      if (original)
+        PUSH (*original, unsigned_lit);
       if (mark == -sign) {
         ROG ("skipping trivial clause");
         trivial = true;
@@ -200,9 +208,8 @@ void parse_dimacs_body (struct ruler *ruler, int variables, int expected) {
       } else
         assert (mark == sign);
     } else {
-#ifndef NDEBUG
-      PUSH (*original, INVALID);
-#endif
+      if (original)
+        PUSH (*original, INVALID);
       parsed++;
       unsigned *literals = clause.begin;
       if (!ruler->inconsistent && !trivial) {
@@ -226,7 +233,7 @@ void parse_dimacs_body (struct ruler *ruler, int variables, int expected) {
           new_ruler_binary_clause (ruler, literals[0], literals[1]);
         else {
           struct clause *large_clause =
-              new_large_clause (size, literals, false, 0);
+              new_large_clause (ruler->arenas, size, literals, false, 0);
           ROGCLAUSE (large_clause, "new");
           PUSH (ruler->clauses, large_clause);
         }
@@ -251,6 +258,7 @@ void parse_dimacs_body (struct ruler *ruler, int variables, int expected) {
 #endif
   RELEASE (clause);
   ruler->statistics.original = parsed;
+  ruler->exchange.formula = hash;
   free (marked);
 #ifndef QUIET
   double end_parsing = STOP (ruler, parse);
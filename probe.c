@@ -29,6 +29,7 @@ int probe (struct ring *ring) {
   assert (ring->context == SEARCH_CONTEXT);
   ring->context = PROBING_CONTEXT;
   ring->statistics.probings++;
+  clear_saved_trail (ring);
   failed_literal_probing (ring);
   vivify_clauses (ring);
   ring->context = SEARCH_CONTEXT;
@@ -31,6 +31,7 @@ struct ring_profiles {
 };
 
 #define RULER_PROFILES \
+  RULER_PROFILE (bva) \
   RULER_PROFILE (clone) \
   RULER_PROFILE (eliminate) \
   RULER_PROFILE (deduplicate) \
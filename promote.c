@@ -6,7 +6,7 @@
 #include "cover.h" // TODO remove
 
 unsigned recompute_glue (struct ring *ring, struct watcher *watcher) {
-  unsigned limit = watcher->glue;
+  unsigned limit = watcher_to_usage (ring, watcher)->glue;
   struct unsigneds *promote = &ring->promote;
   struct variable *variables = ring->variables;
   unsigned char *used = ring->used;
@@ -36,7 +36,8 @@ unsigned recompute_glue (struct ring *ring, struct watcher *watcher) {
 
 void promote_watcher (struct ring *ring, struct watcher *watcher,
                       unsigned new_glue) {
-  unsigned watcher_glue = watcher->glue;
+  struct watcher_usage *usage = watcher_to_usage (ring, watcher);
+  unsigned watcher_glue = usage->glue;
   assert (new_glue < watcher_glue);
   struct clause *clause = watcher->clause;
   for (;;) {
@@ -55,7 +56,7 @@ void promote_watcher (struct ring *ring, struct watcher *watcher,
     } while (tmp_glue < new_glue);
   }
   ring->statistics.promoted.clauses++;
-  watcher->glue = new_glue;
+  usage->glue = new_glue;
   unsigned tier1 = ring->tier1_glue_limit[ring->stable];
   unsigned tier2 = ring->tier2_glue_limit[ring->stable];
   if (new_glue <= tier1) {
@@ -1,12 +1,138 @@
 #include "propagate.h"
 #include "assign.h"
+#include "backtrack.h"
+#include "geatures.h"
 #include "macros.h"
 #include "message.h"
 #include "ruler.h"
+#include "simd.h"
 #include "utilities.h"
 
-struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
-                              struct clause *ignore) {
+static inline unsigned *
+find_non_false_literal (signed char *values, unsigned *begin, unsigned *end,
+                        unsigned not_lit, unsigned other, bool simd) {
+  if (simd && end - begin >= MIN_SIMD_LITERALS)
+    return simd_find_non_false_literal (values, begin, end, not_lit, other);
+  unsigned *p = begin;
+  while (p != end) {
+    unsigned lit = *p;
+    if (lit != not_lit && lit != other && values[lit] >= 0)
+      break;
+    p++;
+  }
+  return p;
+}
+
+#ifdef GIMSATUL_HAS_PREFETCH
+
+// Watchers of the watch 'distance' positions ahead are prefetched as
+// well as the clauses of the watches half that distance ahead, for which
+// the watchers should already be in the cache.  Watches with a satisfied
+// blocking literal are skipped as they will not be dereferenced.
+
+static inline void prefetch_watches (struct ring *ring, signed char *values,
+                                     struct watch **p, struct watch **end,
+                                     unsigned distance) {
+  if ((size_t) (end - p) > distance) {
+    struct watch *watch = p[distance];
+    if (values[other_pointer (watch)] <= 0) {
+      unsigned idx = index_pointer (watch);
+      __builtin_prefetch (index_to_watcher (ring, idx));
+    }
+  }
+  unsigned half = distance / 2;
+  if (half && (size_t) (end - p) > half) {
+    struct watch *watch = p[half];
+    if (values[other_pointer (watch)] <= 0) {
+      unsigned idx = index_pointer (watch);
+      struct watcher *watcher = index_to_watcher (ring, idx);
+      if (!watcher->size)
+        __builtin_prefetch (watcher->clause->literals);
+    }
+  }
+}
+
+#endif
+
+// A saved assignment can only be replayed if its reason is still a
+// falsified clause except for the saved literal itself.
+
+static bool replayable_reason (struct ring *ring, signed char *values,
+                               unsigned lit, struct watch *reason) {
+  if (!reason)
+    return false;
+  if (is_binary_pointer (reason)) {
+    assert (lit_pointer (reason) == lit);
+    return values[other_pointer (reason)] < 0;
+  }
+  struct watcher *watcher = get_watcher (ring, reason);
+  if (watcher->garbage)
+    return false;
+  for (all_watcher_literals (other, watcher))
+    if (other != lit && values[other] >= 0)
+      return false;
+  return true;
+}
+
+// If the propagated literal is the next saved literal, then the saved
+// literals following it are assigned again with their saved reasons.
+// Replaying stops at the first saved literal without a valid reason
+// (including saved decisions).  Falsified saved literals invalidate the
+// rest of the saved trail.
+
+static uint64_t replay_saved_trail (struct ring *ring, signed char *values,
+                                    unsigned lit) {
+  struct saved_trail *saved = &ring->saved_trail;
+  struct saved_assignment *begin = saved->begin + saved->head;
+  struct saved_assignment *end = saved->end, *p = begin;
+  if (p == end)
+    return 0;
+  if (p->lit != lit) {
+    if (values[p->lit] < 0)
+      clear_saved_trail (ring);
+    return 0;
+  }
+  p++;
+  uint64_t reused = 0;
+  while (p != end) {
+    unsigned other = p->lit;
+    signed char value = values[other];
+    if (value < 0) {
+      LOG ("saved %s falsified", LOGLIT (other));
+      clear_saved_trail (ring);
+      break;
+    }
+    if (!value) {
+      if (!replayable_reason (ring, values, other, p->reason))
+        break;
+      assign_with_reason (ring, other, p->reason);
+      reused++;
+    }
+    p++;
+  }
+  if (!EMPTY (*saved))
+    saved->head = p - saved->begin;
+  LOG ("replayed %" PRIu64 " saved literals", reused);
+  ring->statistics.trail.reused += reused;
+  uint64_t ticks = 1 + cache_lines (p, begin);
+  ring->statistics.trail.ticks += ticks;
+  return ticks;
+}
+
+// The propagation kernel is instantiated for the three different contexts
+// below with constant arguments.  Forcing inlining makes sure that the
+// compiler removes the branches on 'stop_at_conflict', 'replay' and
+// 'ignore' from the inner loops, similar to template instantiation in C++.
+
+#ifdef __GNUC__
+#define ALWAYS_INLINE inline __attribute__ ((always_inline))
+#else
+#define ALWAYS_INLINE inline
+#endif
+
+static ALWAYS_INLINE struct watch *
+propagate_kernel (struct ring *ring, const bool stop_at_conflict,
+                  const bool replay, struct clause *ignore) {
   assert (!ring->inconsistent);
   assert (!ignore || !is_binary_pointer (ignore));
   struct ring_trail *trail = &ring->trail;
@@ -15,6 +141,11 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
   uint64_t *visits = ring->statistics.contexts[ring->context].visits;
 #endif
   signed char *values = ring->values;
+  _Atomic (struct store_chunk *) *stored = ring->ruler->store.chunks;
+  const bool simd = ring->simd;
+#ifdef GIMSATUL_HAS_PREFETCH
+  const unsigned prefetch = ring->options.prefetch;
+#endif
   uint64_t ticks = 0, propagations = 0;
   while (trail->propagate != trail->end) {
     if (stop_at_conflict && conflict)
@@ -22,6 +153,8 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
     unsigned lit = *trail->propagate++;
     LOG ("propagating %s", LOGLIT (lit));
     propagations++;
+    if (replay && ring->saved_trail.end != ring->saved_trail.begin)
+      ticks += replay_saved_trail (ring, values, lit);
     unsigned not_lit = NOT (lit);
     struct references *watches = &REFERENCES (not_lit);
 
@@ -55,7 +188,67 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
         break;
     }
 
-    // Then traverse (and update) the watch list of the literal.
+    // Then traverse the redundant binary clauses.  Only learned and
+    // thus redundant binary clauses are kept in these ring local arrays,
+    // where they are really copied (if shared among rings).  They are
+    // kept separate from the watches of large clauses to avoid having to
+    // distinguish binary from large clause watches below.
+
+    struct unsigneds *redundant = &watches->redundant;
+    if (!EMPTY (*redundant)) {
+      unsigned *begin = redundant->begin, *end = redundant->end, *p;
+      for (p = begin; p != end; p++) {
+        unsigned other = *p;
+        signed char other_value = values[other];
+        if (other_value < 0) {
+          conflict = tag_binary (true, not_lit, other);
+          if (stop_at_conflict)
+            break;
+        } else if (!other_value) {
+          struct watch *reason = tag_binary (true, other, not_lit);
+          assign_with_reason (ring, other, reason);
+          ticks++;
+        }
+      }
+
+      ticks += cache_lines (p, begin);
+      if (stop_at_conflict && conflict)
+        break;
+    }
+
+    // Then traverse the learned binary clauses in the global store (see
+    // 'store.h') if enabled.  Slots reserved but not yet filled in by
+    // other rings are skipped.  If such a clause is missed here it is
+    // imported later, which forces the literal to be repropagated.
+
+    if (stored) {
+      for (all_stored_chunks (chunk, stored, not_lit)) {
+        unsigned size = stored_chunk_size (chunk);
+        for (unsigned i = 0; i != size; i++) {
+          unsigned other = atomic_load_explicit (chunk->others + i,
+                                                 memory_order_relaxed);
+          if (other == INVALID)
+            continue;
+          signed char other_value = values[other];
+          if (other_value < 0) {
+            conflict = tag_binary (true, not_lit, other);
+            if (stop_at_conflict)
+              break;
+          } else if (!other_value) {
+            struct watch *reason = tag_binary (true, other, not_lit);
+            assign_with_reason (ring, other, reason);
+            ticks++;
+          }
+        }
+        ticks++;
+        if (stop_at_conflict && conflict)
+          break;
+      }
+      if (stop_at_conflict && conflict)
+        break;
+    }
+
+    // Finally traverse (and update) the watch list of the literal.
 
     struct watch **begin = watches->begin, **q = begin;
     struct watch **end = watches->end, **p = begin;
@@ -64,28 +257,23 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
 
     while (p != end) {
       assert (!stop_at_conflict || !conflict);
+#ifdef GIMSATUL_HAS_PREFETCH
+      if (prefetch)
+        prefetch_watches (ring, values, p, end, prefetch);
+#endif
       struct watch *watch = *q++ = *p++;
 
-      // This tagged 'watch' pointer is either a binary watch or an
-      // index to the corresponding watcher in the (ring/thread local)
-      // watcher stack.  Tagging uses bit-stuffing to distinguish these
-      // two cases, through the least significand bit actually.
-
-      // If the clause is binary (least significand bit set) we find the
-      // other literal of the binary clause in the upper half of the
-      // pointer (together with another bit which encodes redundancy).
-      // The lower half of the pointer encodes the negation of the
-      // propagated literal.
-
-      // For larger (non-binary) clauses we have a similar situation and
-      // store in the upper half of the watch pointer word the blocking
-      // literal (conceptually an abitrary literal of the clause but
-      // supposed to be different from the negated propagaged literal).
-      // The other literal of binary clauses plays the same role.
+      // This tagged 'watch' pointer is an index to the corresponding
+      // watcher in the (ring/thread local) watcher stack.  In the upper
+      // half of the watch pointer word we store the blocking literal
+      // (conceptually an abitrary literal of the clause but supposed to
+      // be different from the negated propagaged literal).
 
       // Now we check first, which often happens, whether this blocking
-      // literal of both binary and large clauses is actually already
-      // satisfied, in which case we just continue (and keep the watch).
+      // literal is actually already satisfied, in which case we just
+      // continue (and keep the watch).
+
+      assert (!is_binary_pointer (watch));
 
       unsigned blocking = other_pointer (watch);
       assert (lit != blocking);
@@ -94,185 +282,161 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
       if (blocking_value > 0)
         continue;
 
-      if (is_binary_pointer (watch)) {
-        assert (lit_pointer (watch) == not_lit);
-        if (blocking_value < 0) {
-          conflict = watch;
-          if (stop_at_conflict)
-            break;
-        } else {
-          // Only learned and thus redundant clauses are kept as
-          // virtual binary clauses, where virtual means that
-          // they only exist in the watch list of this ring.  They
-          // are thus really copied (if shared among rings).
-
-          assert (redundant_pointer (watch));
-
-          // The 'assign' function expects the literals in the
-          // opposite order as 'watch' and we have in essence to
-          // swap upper and lower half of the watch pointer word.
+      // We now have to access the actual watcher data ...
 
-          struct watch *reason = tag_binary (true, blocking, not_lit);
+      unsigned idx = index_pointer (watch);
+      struct watcher *watcher = index_to_watcher (ring, idx);
 
-          assert (reason != watch);
-          assign_with_reason (ring, blocking, reason);
-          ticks++;
-        }
-      } else {
-        // We now have to access the actual watcher data ...
+      ticks++; // ... and pay the prize.
 
-        unsigned idx = index_pointer (watch);
-        struct watcher *watcher = index_to_watcher (ring, idx);
+      // Satisfied (and vivified) but not removed clauses (actually
+      // watchers to the clause) might still be watched and should
+      // be ignored during propagation.
 
-        ticks++; // ... and pay the prize.
-
-        // Satisfied (and vivified) but not removed clauses (actually
-        // watchers to the clause) might still be watched and should
-        // be ignored during propagation.
+      if (watcher->garbage) // This induces the 'tick' above.
+        continue;
 
-        if (watcher->garbage) // This induces the 'tick' above.
-          continue;
+      // Ignore the vivified clause during vivification.
 
-        // Ignore the vivified clause during vivification.
+      struct clause *clause = watcher->clause;
+      if (ignore && clause == ignore)
+        continue;
 
-        struct clause *clause = watcher->clause;
-        if (ignore && clause == ignore)
+      // The watchers need to precisely know the two watched
+      // literals, which might be different from the blocking
+      // literal.  Otherwise unit propagation is not efficient
+      // (other invariants might also break).
+
+      // However as watchers are only accessed while traversing a
+      // watch list we always know during such a traversal already
+      // one of the two literals.  Therefore we can simply use the
+      // XOR trick and only store the bit-wise difference (the
+      // 'XOR') between the two watched literals in the watcher
+      // instead of both literals and get the other watched literal
+      // during traversal by adding (with 'XOR') to that difference.
+
+      unsigned other = watcher->sum ^ not_lit;
+
+      signed char other_value;
+      if (other == blocking)
+        other_value = blocking_value;
+      else {
+        other_value = values[other];
+        if (other_value > 0) {
+          bool redundant = redundant_pointer (watch);
+          watch = tag_index (redundant, idx, other);
+          q[-1] = watch;
           continue;
-
-        unsigned watcher_glue = watcher->glue;
-        unsigned clause_glue = clause->glue;
-        assert (clause_glue <= watcher_glue);
-        if (clause_glue < watcher_glue) {
-          watcher->glue = clause_glue;
-          LOGWATCH (watch, "updated from glue %u to", watcher_glue);
         }
+      }
 
-        // The watchers need to precisely know the two watched
-        // literals, which might be different from the blocking
-        // literal.  Otherwise unit propagation is not efficient
-        // (other invariants might also break).
-
-        // However as watchers are only accessed while traversing a
-        // watch list we always know during such a traversal already
-        // one of the two literals.  Therefore we can simply use the
-        // XOR trick and only store the bit-wise difference (the
-        // 'XOR') between the two watched literals in the watcher
-        // instead of both literals and get the other watched literal
-        // during traversal by adding (with 'XOR') to that difference.
-
-        unsigned other = watcher->sum ^ not_lit;
-
-        signed char other_value;
-        if (other == blocking)
-          other_value = blocking_value;
-        else {
-          other_value = values[other];
-          if (other_value > 0) {
-            bool redundant = redundant_pointer (watch);
-            watch = tag_index (redundant, idx, other);
-            q[-1] = watch;
-            continue;
+      // Now neither the blocking literal nor the other watched
+      // literal (if different) are assigned to true, and it is time
+      // to either find a non-false replacement watched literal, or
+      // determine that the clause is unit or conflicting (all
+      // replacement candidates are false).
+
+      unsigned replacement = INVALID;
+      signed char replacement_value = -1;
+
+      // The watchers can store literals of short clauses (by default
+      // three or four literals long) directly in the watcher data
+      // structure in order to avoid a second pointer dereference
+      // (not needed for sequential solvers) to the actual clause
+      // data (the latter being shared among threads).  While
+      // initializing the watcher the size field is set to the
+      // actual size of the clause if it is short enough and to zero
+      // if it is too long (more than 'SIZE_WATCHER_LITERALS').
+
+      unsigned watcher_size = watcher->size;
+      if (watcher_size) {
+#ifdef METRICS
+        assert (watcher_size < SIZE_VISITS);
+        visits[watcher_size]++;
+#endif
+        unsigned *literals = watcher->aux;
+        unsigned *end_literals = literals + watcher_size;
+        for (unsigned *r = literals; r != end_literals; r++) {
+          replacement = *r;
+          if (replacement != not_lit && replacement != other) {
+            replacement_value = values[replacement];
+            if (replacement_value >= 0)
+              break;
           }
         }
-
-        // Now the irredundant and virtual redundant binary clauses
-        // are handled and neither the blocking literal nor the other
-        // watched literal (if different) are assigned to true, and
-        // it is time to either find a non-false replacement watched
-        // literal, or determine that the clause is unit or
-        // conflicting (all replacement candidates are false).
-
-        unsigned replacement = INVALID;
-        signed char replacement_value = -1;
-
-        // The watchers can store literals of short clauses (currently
-        // three or four literals long) directly in the watcher data
-        // structure in order to avoid a second pointer dereference
-        // (not needed for sequential solvers) to the actual clause
-        // data (the latter being shared among threads).  While
-        // initializing the watcher the size field is set to the
-        // actual size of the clause if it is short enough and to zero
-        // if it is too long (has more than four literals).
-
-        unsigned watcher_size = watcher->size;
-        if (watcher_size) {
-          unsigned *literals = watcher->aux;
-          unsigned *end_literals = literals + watcher_size;
-          for (unsigned *r = literals; r != end_literals; r++) {
-            replacement = *r;
-            if (replacement != not_lit && replacement != other) {
-              replacement_value = values[replacement];
-              if (replacement_value >= 0)
-                break;
-            }
-          }
-        } else {
-          // Now we pay the prize of accessing the actual clause too
-          // (one of the following 'clause->size' accesses).
-
-          // During propagation the 'tick' above for accessing
-          // watchers and this one form the hot-spots of the solver,
-          // due to irregular memory access (cache read misses).
-          // All this special treatment of binary clauses, the
-          // blocking literal and keeping short clause literals
-          // directly in the watcher data-structure are all only
-          // used to reduce the time spent in these two hot-spots.
-
-          // The following code matches the same standard
-          // propagation code in for instance CaDiCaL and Kissat.
-
-          ticks++;
+      } else {
+        // Now we pay the prize of accessing the actual clause too
+        // (one of the following 'clause->size' accesses).
+
+        // During propagation the 'tick' above for accessing
+        // watchers and this one form the hot-spots of the solver,
+        // due to irregular memory access (cache read misses).
+        // All this special treatment of binary clauses, the
+        // blocking literal and keeping short clause literals
+        // directly in the watcher data-structure are all only
+        // used to reduce the time spent in these two hot-spots.
+
+        // The following code matches the same standard
+        // propagation code in for instance CaDiCaL and Kissat,
+        // except that long stretches of literals are searched with
+        // a vectorized kernel if the CPU supports it.
+
+        ticks++;
 #ifdef METRICS
-          assert (clause->size > 2);
-          if (clause->size >= SIZE_VISITS)
-            visits[0]++;
-          else
-            visits[clause->size]++;
+        assert (clause->size > 2);
+        if (clause->size >= SIZE_VISITS)
+          visits[0]++;
+        else
+          visits[clause->size]++;
 #endif
-          unsigned *literals = clause->literals;
-          unsigned *end_literals = literals + clause->size;
-          assert (watcher->aux[0] <= clause->size);
-          unsigned *middle_literals = literals + watcher->aux[0];
-          unsigned *r = middle_literals;
-          while (r != end_literals) {
-            replacement = *r;
-            if (replacement != not_lit && replacement != other) {
-              replacement_value = values[replacement];
-              if (replacement_value >= 0)
-                break;
-            }
-            r++;
-          }
-          if (replacement_value < 0) {
-            r = literals;
-            while (r != middle_literals) {
-              replacement = *r;
-              if (replacement != not_lit && replacement != other) {
-                replacement_value = values[replacement];
-                if (replacement_value >= 0)
-                  break;
-              }
-              r++;
-            }
-          }
-          watcher->aux[0] = r - literals;
+        unsigned *literals = clause->literals;
+        unsigned *end_literals = literals + clause->size;
+        assert (watcher->aux[0] <= clause->size);
+        unsigned *middle_literals = literals + watcher->aux[0];
+        unsigned *r = find_non_false_literal (
+            values, middle_literals, end_literals, not_lit, other, simd);
+        bool found = r != end_literals;
+        if (!found) {
+          r = find_non_false_literal (values, literals, middle_literals,
+                                      not_lit, other, simd);
+          found = r != middle_literals;
         }
+        if (found) {
+          replacement = *r;
+          replacement_value = values[replacement];
+          assert (replacement_value >= 0);
+        }
+        watcher->aux[0] = r - literals;
+      }
 
-        if (replacement_value >= 0) {
-          watcher->sum = other ^ replacement;
-          LOGCLAUSE (clause, "unwatching %s in", LOGLIT (not_lit));
-          watch_literal (ring, replacement, other, watcher);
-          ticks++;
-          q--;
-        } else if (other_value) {
-          assert (other_value < 0);
-          conflict = watch;
-          if (stop_at_conflict)
-            break;
-        } else {
-          assign_with_reason (ring, other, watch);
-          ticks++;
+      if (replacement_value >= 0) {
+        watcher->sum = other ^ replacement;
+        LOGCLAUSE (clause, "unwatching %s in", LOGLIT (not_lit));
+        struct references *replacement_watches = &REFERENCES (replacement);
+        if (FULL (*replacement_watches)) {
+          // Enlarging the replacement watch list might move all watch
+          // lists in the watch arena including the one traversed here.
+          size_t p_pos = p - begin, q_pos = q - begin;
+          size_t end_pos = end - begin;
+          enlarge_vector (ring, replacement_watches);
+          begin = watches->begin;
+          p = begin + p_pos, q = begin + q_pos, end = begin + end_pos;
         }
+        bool redundant = watcher->redundant;
+        struct watch *replacement_watch = tag_index (redundant, idx, other);
+        LOGWATCH (replacement_watch, "watching %s in",
+                  LOGLIT (replacement));
+        *replacement_watches->end++ = replacement_watch;
+        ticks++;
+        q--;
+      } else if (other_value) {
+        assert (other_value < 0);
+        conflict = watch;
+        if (stop_at_conflict)
+          break;
+      } else {
+        assign_with_reason (ring, other, watch);
+        ticks++;
       }
     }
     while (p != end)
@@ -280,7 +444,7 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
     ticks += cache_lines (p, begin);
     watches->end = q;
     if (q == watches->begin)
-      RELEASE (*watches);
+      release_vector (ring, watches);
   }
 
   struct ring_statistics *statistics = &ring->statistics;
@@ -307,3 +471,16 @@ struct watch *ring_propagate (struct ring *ring, bool stop_at_conflict,
 
   return conflict;
 }
+
+struct watch *search_propagate (struct ring *ring) {
+  return propagate_kernel (ring, true, true, 0);
+}
+
+struct watch *probing_propagate (struct ring *ring) {
+  return propagate_kernel (ring, false, false, 0);
+}
+
+struct watch *vivify_propagate (struct ring *ring, struct clause *ignore) {
+  assert (ignore);
+  return propagate_kernel (ring, false, false, ignore);
+}
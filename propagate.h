@@ -1,12 +1,22 @@
 #ifndef _propagate_h_INCLUDED
 #define _propagate_h_INCLUDED
 
-#include <stdbool.h>
-
 struct clause;
 struct ring;
 
-struct watch *ring_propagate (struct ring *, bool stop_at_conflict,
-                              struct clause *ignored_large_clause);
+// Stops at the first conflict as needed during search.
+
+struct watch *search_propagate (struct ring *);
+
+// Propagates all literals on the trail even if a conflict was found,
+// which is used during probing, vivification and warming up phases.
+
+struct watch *probing_propagate (struct ring *);
+
+// Same as 'probing_propagate' but ignores the given large clause, which
+// is the clause being vivified.
+
+struct watch *vivify_propagate (struct ring *,
+                                struct clause *ignored_large_clause);
 
 #endif
@@ -1,5 +1,7 @@
 #include "reduce.h"
+#include "backtrack.h"
 #include "barrier.h"
+#include "import.h"
 #include "macros.h"
 #include "message.h"
 #include "report.h"
@@ -25,16 +27,12 @@ void check_clause_statistics (struct ring *ring) {
 
     for (all_ring_literals (lit)) {
       struct references *watches = &REFERENCES (lit);
-      for (all_watches (watch, *watches)) {
-        if (!is_binary_pointer (watch))
-          continue;
-        assert (lit == lit_pointer (watch));
-        unsigned other = other_pointer (watch);
-        if (lit < other)
-          continue;
-        assert (redundant_pointer (watch));
-        redundant++;
-      }
+      for (all_watches (watch, *watches))
+        assert (!is_binary_pointer (watch));
+
+      for (all_elements_on_stack (unsigned, other, watches->redundant))
+        if (other < lit)
+          redundant++;
 
       unsigned *binaries = watches->binaries;
       if (!binaries)
@@ -140,19 +138,24 @@ static void gather_reduce_candidates (struct ring *ring,
   struct watcher *begin = watchers->begin;
   struct watcher *end = watchers->end;
   struct watcher *redundant = begin + ring->redundant;
+  struct watcher_usage *usage = ring->usages.begin + ring->redundant;
   unsigned tier1 = ring->tier1_glue_limit[ring->stable];
   unsigned tier2 = ring->tier2_glue_limit[ring->stable];
-  for (struct watcher *watcher = redundant; watcher != end; watcher++) {
+  for (struct watcher *watcher = redundant; watcher != end;
+       watcher++, usage++) {
     if (!watcher->redundant)
       continue;
     if (watcher->garbage)
       continue;
-    const unsigned char used = watcher->used;
+    const unsigned char used = usage->used;
     if (used)
-      watcher->used = used - 1;
+      usage->used = used - 1;
     if (watcher->reason)
       continue;
-    const unsigned char glue = watcher->glue;
+    unsigned clause_glue = watcher->clause->glue;
+    if (clause_glue < usage->glue)
+      usage->glue = clause_glue;
+    const unsigned char glue = usage->glue;
     if (glue <= tier1 && used)
       continue;
     if (glue <= tier2 && used >= MAX_USED - 1)
@@ -179,9 +182,10 @@ mark_reduce_candidates_as_garbage (struct ring *ring,
     struct watcher *watcher = index_to_watcher (ring, idx);
     mark_garbage_watcher (ring, watcher);
     ring->statistics.reduced.clauses++;
-    if (watcher->glue <= tier1)
+    unsigned glue = index_to_usage (ring, idx)->glue;
+    if (glue <= tier1)
       ring->statistics.reduced.tier1++;
-    else if (watcher->glue <= tier2)
+    else if (glue <= tier2)
       ring->statistics.reduced.tier2++;
     else
       ring->statistics.reduced.tier3++;
@@ -206,17 +210,12 @@ static void flush_references (struct ring *ring, bool fixed, unsigned start,
         lit_value = 0;
     }
     struct references *watches = &REFERENCES (lit);
-    struct watch **begin = watches->begin, **q = begin;
-    struct watch **end = watches->end;
-    for (struct watch **p = begin; p != end; p++) {
-      struct watch *watch = *p;
-      if (is_binary_pointer (watch)) {
-        assert (lit == lit_pointer (watch));
-        if (!fixed) {
-          *q++ = watch;
-          continue;
-        }
-        unsigned other = other_pointer (watch);
+    if (fixed) {
+      struct unsigneds *redundant = &watches->redundant;
+      unsigned *begin = redundant->begin, *q = begin;
+      unsigned *end = redundant->end;
+      for (unsigned *p = begin; p != end; p++) {
+        unsigned other = *p;
         assert (lit != other);
         signed char other_value = values[other];
         if (other_value > 0) {
@@ -225,34 +224,41 @@ static void flush_references (struct ring *ring, bool fixed, unsigned start,
         }
         if (lit_value > 0 || other_value > 0) {
           if (lit < other) {
-            bool redundant = redundant_pointer (watch);
-            dec_clauses (ring, redundant);
+            dec_clauses (ring, true);
             trace_delete_binary (&ring->trace, lit, other);
           }
 #if !defined(QUIET) || !defined(NDEBUG)
           flushed++;
 #endif
         } else
-          *q++ = watch;
+          *q++ = other;
+      }
+      redundant->end = q;
+      SHRINK_STACK (*redundant);
+    }
+    struct watch **begin = watches->begin, **q = begin;
+    struct watch **end = watches->end;
+    for (struct watch **p = begin; p != end; p++) {
+      struct watch *watch = *p;
+      assert (!is_binary_pointer (watch));
+      unsigned src = index_pointer (watch);
+      unsigned dst = map_idx (src, start, map);
+      if (dst) {
+        bool redundant = redundant_pointer (watch);
+        unsigned other = other_pointer (watch);
+        struct watch *mapped = tag_index (redundant, dst, other);
+        *q++ = mapped;
       } else {
-        unsigned src = index_pointer (watch);
-        unsigned dst = map_idx (src, start, map);
-        if (dst) {
-          assert (dst);
-          bool redundant = redundant_pointer (watch);
-          unsigned other = other_pointer (watch);
-          struct watch *mapped = tag_index (redundant, dst, other);
-          *q++ = mapped;
-        } else {
 #if !defined(QUIET) || !defined(NDEBUG)
-          flushed++;
+        flushed++;
 #endif
-        }
       }
     }
     watches->end = q;
-    SHRINK_STACK (*watches);
+    if (q == begin)
+      release_vector (ring, watches);
   }
+  defrag_vectors (ring, 0);
   assert (!(flushed & 1));
   verbose (ring, "flushed %zu garbage watches from watch lists", flushed);
 }
@@ -265,6 +271,9 @@ void reduce (struct ring *ring) {
   struct ring_statistics *statistics = &ring->statistics;
   struct ring_limits *limits = &ring->limits;
   statistics->reductions++;
+  clear_saved_trail (ring);
+  update_import_feedback (ring);
+  reconcile_deferred_dereferences (ring);
   verbose (ring, "reduction %" PRIu64 " at %" PRIu64 " conflicts",
            statistics->reductions, SEARCH_CONFLICTS);
   bool fixed = ring->last.fixed != ring->statistics.fixed;
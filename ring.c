@@ -3,6 +3,7 @@
 #include "message.h"
 #include "random.h"
 #include "ruler.h"
+#include "simd.h"
 #include "utilities.h"
 
 #include <assert.h>
@@ -80,7 +81,7 @@ void init_ring (struct ring *ring) {
   assert (!ring->used);
 
   ring->marks = allocate_and_clear_block (2 * size);
-  ring->values = allocate_and_clear_block (2 * size);
+  ring->values = allocate_and_clear_block (2 * size + VALUES_PADDING);
   ring->inactive = allocate_and_clear_block (size);
   ring->used = allocate_and_clear_array (size, sizeof *ring->used);
 
@@ -114,6 +115,10 @@ static void init_watchers (struct ring *ring) {
   ENLARGE (ring->watchers);
   memset (ring->watchers.begin, 0, sizeof *ring->watchers.begin);
   ring->watchers.end++;
+  assert (EMPTY (ring->usages));
+  ENLARGE (ring->usages);
+  memset (ring->usages.begin, 0, sizeof *ring->usages.begin);
+  ring->usages.end++;
 }
 
 void reset_last_learned (struct ring *ring) {
@@ -144,6 +149,10 @@ void release_ring (struct ring *ring, bool keep_values) {
   RELEASE (ring->exports);
 
   FREE (ring->references);
+  release_vectors (ring);
+
+  RELEASE (ring->saved_trail);
+  ring->saved_trail.head = 0;
 
   struct ring_trail *trail = &ring->trail;
   free (trail->begin);
@@ -212,6 +221,7 @@ struct ring *new_ring (struct ruler *ruler) {
 
   struct ring *ring = allocate_and_clear_block (sizeof *ring);
   ring->options = ruler->options;
+  ring->simd = ring->options.simd && has_simd_support ();
 #ifndef QUIET
   init_ring_profiles (ring);
 #endif
@@ -221,6 +231,7 @@ struct ring *new_ring (struct ruler *ruler) {
 
   init_watchers (ring);
   reset_last_learned (ring);
+  init_store_cursor (ring);
   init_ring (ring);
 
   struct heap *heap = &ring->heap;
@@ -253,9 +264,10 @@ static void release_watchers (struct ring *ring) {
     unsigned shared = atomic_fetch_sub (&clause->shared, 1);
     assert (shared + 1);
     if (!shared)
-      free (clause);
+      deallocate_clause (ring->arena, clause);
   }
   RELEASE (ring->watchers);
+  RELEASE (ring->usages);
 }
 
 static void release_saved (struct ring *ring) {
@@ -270,7 +282,7 @@ static void release_saved (struct ring *ring) {
     assert (shared + 1);
     if (shared)
       continue;
-    free (clause);
+    deallocate_clause (ring->arena, clause);
   }
   RELEASE (ring->saved);
 }
@@ -279,13 +291,21 @@ void init_pool (struct ring *ring, unsigned threads) {
   ring->threads = threads;
   ring->pool =
       allocate_aligned_array (CACHE_LINE_SIZE, threads, sizeof *ring->pool);
-  struct bucket *b = ring->pool[0].bucket;
-  struct bucket *end = b + threads * SIZE_POOL;
-  while (b != end) {
-    b->shared = 0;
-    b->redundancy = MAX_REDUNDANCY;
-    b++;
+  memset (ring->pool, 0, threads * sizeof *ring->pool);
+  unsigned capacity = ring->options.pool_capacity;
+  for (struct pool *p = ring->pool; p != ring->pool + threads; p++) {
+    for (struct bucket *b = p->bucket; b != p->bucket + SIZE_POOL; b++)
+      b->redundancy = MAX_REDUNDANCY;
+    p->capacity = capacity;
+    p->adapt.next = POOL_ADAPT_PERIOD * capacity;
+    if (ring->options.telemetry)
+      p->stamps = allocate_and_clear_array (SIZE_POOL, sizeof *p->stamps);
   }
+  ring->sources = allocate_aligned_array (CACHE_LINE_SIZE, threads,
+                                          sizeof *ring->sources);
+  memset (ring->sources, 0, threads * sizeof *ring->sources);
+  for (unsigned i = 0; i != threads; i++)
+    ring->sources[i].weight = 1;
 }
 
 static void release_pool (struct ring *ring) {
@@ -295,6 +315,7 @@ static void release_pool (struct ring *ring) {
   struct pool *skip_pool = begin_pool + ring->id;
   struct pool *end_pool = begin_pool + ring->threads;
   for (struct pool *p = begin_pool; p != end_pool; p++) {
+    free (p->stamps);
     if (p == skip_pool)
       continue;
     struct bucket *begin_bucket = p->bucket;
@@ -309,11 +330,12 @@ static void release_pool (struct ring *ring) {
       assert (shared + 1);
       if (!shared) {
         LOGCLAUSE (clause, "final delete");
-        free (clause);
+        deallocate_clause (ring->arena, clause);
       }
     }
   }
   deallocate_aligned (CACHE_LINE_SIZE, ring->pool);
+  deallocate_aligned (CACHE_LINE_SIZE, ring->sources);
 }
 
 static void release_binaries (struct ring *ring) {
@@ -325,6 +347,7 @@ static void release_binaries (struct ring *ring) {
 void delete_ring (struct ring *ring) {
   verbose (ring, "delete ring[%u]", ring->id);
   release_pool (ring);
+  release_deferred_dereferences (ring);
 
   release_references (ring);
   if (!ring->id)
@@ -11,9 +11,11 @@
 #include "queue.h"
 #include "stack.h"
 #include "statistics.h"
+#include "store.h"
 #include "tagging.h"
 #include "trace.h"
 #include "variable.h"
+#include "vectors.h"
 #include "watches.h"
 
 #include <stdbool.h>
@@ -82,6 +84,16 @@ struct ring_trail {
   unsigned *pos, *propagate;
 };
 
+struct saved_assignment {
+  unsigned lit;
+  struct watch *reason;
+};
+
+struct saved_trail {
+  struct saved_assignment *begin, *end, *allocated;
+  size_t head;
+};
+
 struct ring_units {
   unsigned *begin, *end;
   unsigned *iterate, *export;
@@ -93,16 +105,75 @@ struct ring_units {
 #define LOG_REDUNDANCY(R) (unsigned) ((R) >> 32), (unsigned) (R)
 #endif
 
-#define BINARY_BUCKET 0
-#define SIZE_POOL 8
+// Every ring has one pool of buckets for each other ring to which it
+// exports clauses.  Only the first 'capacity' buckets are used.  This
+// capacity is adapted by the exporting ring to the import rate of the
+// receiving ring every 'POOL_ADAPT_PERIOD' times capacity exports.  It is
+// doubled if more clauses were lost than the receiver imported while the
+// receiver still imported at least a full pool, and halved if the
+// receiver imported less than half a pool.  Lost clauses are either
+// overwritten by later exports or dropped (not placed at all, flushed or
+// removed while shrinking).  The 'imported' counter is the only field
+// written by the receiver.  The export time stamps of the buckets needed
+// for telemetry are kept in a separate array only allocated if enabled.
+
+#define POOL_ADAPT_PERIOD 8
 
 struct bucket {
   uint64_t redundancy;
   atomic_uintptr_t shared;
 };
 
+struct stamp {
+  atomic_uint_fast64_t conflicts;
+  atomic_uint_fast64_t time;
+};
+
 struct pool {
   struct bucket bucket[SIZE_POOL];
+  struct stamp *stamps;
+  atomic_uint capacity;
+  unsigned resized;
+  uint64_t offered;
+  uint64_t exported;
+  uint64_t dropped;
+  uint64_t overwritten;
+  struct {
+    uint64_t next;
+    uint64_t imported;
+    uint64_t lost;
+  } adapt;
+  uint64_t throttled;
+  _Alignas (CACHE_LINE_SIZE) atomic_uint_fast64_t imported;
+};
+
+// Receiving rings count for each source ring the imported large clauses
+// and how often such clauses were bumped as reasons in conflict analysis
+// (the watcher usage records the source).  During reductions the recent
+// counts are decayed and give a usefulness 'weight' of each source, which
+// biases the choice of the source in single clause import.  Sources with
+// less than half the average weight are marked as throttled, which makes
+// them export only tier-1 clauses to this receiver.
+
+struct source {
+  uint64_t imported;
+  uint64_t subsumed;
+  uint64_t used;
+  struct {
+    uint64_t samples;
+    uint64_t conflicts;
+    uint64_t microseconds;
+  } latency;
+  struct {
+    uint64_t imported;
+    uint64_t used;
+  } last;
+  struct {
+    double imported;
+    double used;
+  } recent;
+  double weight;
+  atomic_bool throttle;
 };
 
 struct ring;
@@ -114,14 +185,21 @@ struct rings {
 struct ring {
   unsigned id;
   unsigned threads;
+  unsigned cpu;
+  unsigned domain;
+  struct arena *arena;
   struct pool *pool;
-  unsigned *ruler_units;
+  struct source *sources;
+  _Atomic (unsigned *) ruler_units;
+  uint64_t exchanged;
+  struct store_cursor stored;
   struct ruler *ruler;
 
   volatile int status;
 
   bool import_after_propagation_and_conflict;
   bool inconsistent;
+  bool simd;
   bool stable;
 
   signed char iterating;
@@ -151,9 +229,12 @@ struct ring {
   struct unsigneds outoforder;
   struct unsigneds promote;
   struct rings exports;
+  struct clauses deferred;
 
   struct references *references;
+  struct vectors vectors;
   struct ring_trail trail;
+  struct saved_trail saved_trail;
   struct ring_units ring_units;
   struct variable *variables;
 
@@ -163,6 +244,7 @@ struct ring {
 
   unsigned redundant;
   struct watchers watchers;
+  struct watcher_usages usages;
   unsigned last_learned[4];
   struct saved_watchers saved;
 
@@ -180,6 +262,8 @@ struct ring {
 
   unsigned randec;
   uint64_t random;
+
+  atomic_uint_fast64_t telemetry_conflicts;
 };
 
 /*------------------------------------------------------------------------*/
@@ -277,6 +361,16 @@ static inline struct watcher *index_to_watcher (struct ring *ring,
   return &PEEK (ring->watchers, idx);
 }
 
+static inline struct watcher_usage *index_to_usage (struct ring *ring,
+                                                    unsigned idx) {
+  return &PEEK (ring->usages, idx);
+}
+
+static inline struct watcher_usage *
+watcher_to_usage (struct ring *ring, struct watcher *watcher) {
+  return index_to_usage (ring, watcher_to_index (ring, watcher));
+}
+
 static inline struct watcher *get_watcher (struct ring *ring,
                                            struct watch *watch) {
   assert (!is_binary_pointer (watch));
@@ -295,7 +389,16 @@ static inline struct clause *get_clause (struct ring *ring,
 static inline void push_watch (struct ring *ring, unsigned lit,
                                struct watch *watch) {
   LOGWATCH (watch, "watching %s in", LOGLIT (lit));
-  PUSH (REFERENCES (lit), watch);
+  struct references *references = &REFERENCES (lit);
+  if (FULL (*references))
+    enlarge_vector (ring, references);
+  *references->end++ = watch;
+}
+
+static inline void push_redundant_binary (struct ring *ring, unsigned lit,
+                                          unsigned other) {
+  LOGBINARY (true, lit, other, "watching %s in", LOGLIT (lit));
+  PUSH (REFERENCES (lit).redundant, other);
 }
 
 static inline void watch_literal (struct ring *ring, unsigned lit,
@@ -2,6 +2,7 @@
 #include "message.h"
 #include "pthread.h"
 #include "simplify.h"
+#include "system.h"
 #include "trace.h"
 #include "utilities.h"
 
@@ -39,20 +40,34 @@ struct ruler *new_ruler (size_t size, struct options *opts) {
 
   init_locks (ruler);
 
+  ruler->arenas = new_arenas (opts->threads);
+
   ruler->occurrences =
       allocate_and_clear_array (2 * size, sizeof *ruler->occurrences);
   ruler->values = allocate_and_clear_block (2 * size);
 
+  // The parsed clauses are kept for checking witnesses in debugging mode
+  // and for checking those received from peers in distributed mode.
+
+  bool original = opts->listen || opts->connect;
 #ifndef NDEBUG
-  ruler->original = allocate_and_clear_block (sizeof *ruler->original);
+  original = true;
 #endif
+  if (original)
+    ruler->original = allocate_and_clear_block (sizeof *ruler->original);
   ruler->units.begin = allocate_array (size, sizeof (unsigned));
   ruler->units.propagate = ruler->units.end = ruler->units.begin;
+  ruler->units.reserved = 0;
 
   ruler->trace.binary = opts->binary;
   ruler->trace.file = opts->proof.file ? &opts->proof : 0;
 
   memcpy (&ruler->options, opts, sizeof *opts);
+  if (opts->threads > 1)
+    init_filter (ruler);
+  if (opts->threads > 1 && opts->binary_store && opts->share_learned &&
+      !opts->proof.file)
+    init_store (ruler);
 #ifndef QUIET
   init_ruler_profiles (ruler);
 #endif
@@ -74,19 +89,17 @@ static void release_occurrences (struct ruler *ruler) {
 static void release_clauses (struct ruler *ruler) {
   for (all_clauses (clause, ruler->clauses))
     if (!is_binary_pointer (clause))
-      free (clause);
+      deallocate_clause (ruler->arenas, clause);
   RELEASE (ruler->clauses);
 }
 
-#ifndef NDEBUG
-
 static void release_original (struct ruler *ruler) {
+  if (!ruler->original)
+    return;
   RELEASE (*ruler->original);
   free (ruler->original);
 }
 
-#endif
-
 void delete_ruler (struct ruler *ruler) {
   free (ruler->eliminate);
   free (ruler->subsume);
@@ -99,14 +112,18 @@ void delete_ruler (struct ruler *ruler) {
   release_clauses (ruler);
   RELEASE (ruler->extension[0]);
   RELEASE (ruler->extension[1]);
-#ifndef NDEBUG
   release_original (ruler);
-#endif
   RELEASE (ruler->rings);
   free (ruler->units.begin);
+  detach_exchange (ruler);
+  release_filter (ruler);
+  release_store (ruler);
+  release_topology (ruler);
 
   RELEASE (ruler->trace.buffer);
 
+  delete_arenas (ruler->arenas, ruler->options.threads);
+
   free (ruler);
 }
 
@@ -183,15 +200,26 @@ void connect_large_clause (struct ruler *ruler, struct clause *clause) {
     connect_literal (ruler, lit, clause);
 }
 
-void assign_ruler_unit (struct ruler *ruler, unsigned unit) {
-  signed char *values = (signed char *) ruler->values;
-  unsigned not_unit = NOT (unit);
-  assert (!values[unit]);
-  assert (!values[not_unit]);
-  values[unit] = 1;
-  values[not_unit] = -1;
-  assert (ruler->units.end < ruler->units.begin + ruler->size);
-  *ruler->units.end++ = unit;
+static uint64_t publish_ruler_unit (struct ruler *ruler, unsigned unit,
+                                    double *waited) {
+  struct ruler_trail *units = &ruler->units;
+  size_t pos = atomic_fetch_add_explicit (&units->reserved, 1,
+                                          memory_order_relaxed);
+  assert (pos < ruler->compact);
+  unsigned *slot = units->begin + pos;
+  *slot = unit;
+  uint64_t spins = 0;
+  double start = 0;
+  unsigned *expected = slot;
+  while (!atomic_compare_exchange_weak_explicit (
+      &units->end, &expected, slot + 1, memory_order_release,
+      memory_order_relaxed)) {
+    if (!spins++)
+      start = current_time ();
+    expected = slot;
+  }
+  if (spins)
+    *waited += current_time () - start;
   ROG ("assign %s unit", ROGLIT (unit));
   if (ruler->simplifying)
     ruler->statistics.fixed.simplifying++;
@@ -200,6 +228,45 @@ void assign_ruler_unit (struct ruler *ruler, unsigned unit) {
   ruler->statistics.fixed.total++;
   assert (ruler->statistics.active);
   ruler->statistics.active--;
+  return spins;
+}
+
+static void set_ruler_value (struct ruler *ruler, unsigned lit,
+                             signed char value) {
+  atomic_store_explicit (ruler->values + lit, value, memory_order_relaxed);
+}
+
+void assign_ruler_unit (struct ruler *ruler, unsigned unit) {
+  unsigned not_unit = NOT (unit);
+  assert (!ruler->values[unit]);
+  assert (!ruler->values[not_unit]);
+  set_ruler_value (ruler, unit, 1);
+  set_ruler_value (ruler, not_unit, -1);
+  double waited = 0;
+  (void) publish_ruler_unit (ruler, unit, &waited);
+}
+
+bool export_ruler_unit (struct ring *ring, unsigned unit) {
+  struct ruler *ruler = ring->ruler;
+  unsigned idx = IDX (unit);
+  unsigned pos = LIT (idx);
+  signed char sign = SGN (unit) ? -1 : 1;
+  signed char expected = 0;
+  if (!atomic_compare_exchange_strong_explicit (
+          ruler->values + pos, &expected, sign, memory_order_relaxed,
+          memory_order_relaxed)) {
+    ring->statistics.units.races++;
+    return false;
+  }
+  set_ruler_value (ruler, NOT (pos), -sign);
+  struct ring_statistics *statistics = &ring->statistics;
+  double *waited = &statistics->units.waited;
+  uint64_t spins = publish_ruler_unit (ruler, unit, waited);
+  if (spins) {
+    statistics->units.spins += spins;
+    statistics->units.waiting++;
+  }
+  return true;
 }
 
 void recycle_clause (struct simplifier *simplifier, struct clause *clause,
@@ -249,6 +316,8 @@ void push_ring (struct ruler *ruler, struct ring *ring) {
     fatal_error ("failed to release rings lock while pushing ring");
   assert (id < MAX_THREADS);
   ring->id = id;
+  assert (id < ruler->options.threads);
+  ring->arena = ruler->arenas + id;
   ring->random = ring->id;
   ring->ruler = ruler;
   ring->ruler_units = ruler->units.end;
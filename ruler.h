@@ -1,27 +1,41 @@
 #ifndef _ruler_h_INCLUDED
 #define _ruler_h_INCLUDED
 
+#include "arena.h"
 #include "barrier.h"
 #include "clause.h"
+#include "exchange.h"
+#include "filter.h"
+#include "network.h"
 #include "options.h"
 #include "profile.h"
 #include "ring.h"
+#include "store.h"
+#include "topology.h"
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 
+// Root-level units found by rings are appended to the global unit trail
+// without locking.  Exporting rings first claim the variable by setting
+// its value in 'values' atomically.  Then they reserve a slot by
+// incrementing 'reserved' and publish the unit by moving 'end' past that
+// slot, which has to happen in reservation order.  Importing rings read
+// units up to 'end' only.
+
 struct ruler_trail {
   unsigned *begin;
   unsigned *propagate;
-  unsigned *volatile end;
+  _Atomic (unsigned *) end;
+  atomic_size_t reserved;
 };
 
 #define LOCKS \
   LOCK (rings) \
   LOCK (simplify) \
   LOCK (terminate) \
-  LOCK (units) \
   LOCK (winner)
 
 struct ruler_locks {
@@ -53,6 +67,7 @@ struct ruler_last {
 struct ruler_limits {
   bool initialized;
 
+  uint64_t bva;
   uint64_t elimination;
   uint64_t subsumption;
 
@@ -67,11 +82,13 @@ struct ruler_limits {
 struct ruler {
   unsigned size;
   unsigned compact;
+  unsigned fresh;
 
   struct ring *volatile winner;
 
   volatile bool terminate;
   volatile bool simplify;
+  atomic_bool telemetry;
 
   bool eliminating;
   bool inconsistent;
@@ -82,21 +99,25 @@ struct ruler {
   bool *eliminate;
   bool *subsume;
 
+  struct arena *arenas;
   struct clauses *occurrences;
   pthread_t *threads;
   unsigned *unmap;
-  signed char volatile *values;
+  atomic_schar *values;
 
   struct ruler_barriers barriers;
   struct ruler_locks locks;
 
   struct clauses clauses;
   struct unsigneds extension[2];
-#ifndef NDEBUG
   struct unsigneds *original;
-#endif
   struct rings rings;
   struct ruler_trail units;
+  struct exchange exchange;
+  struct store store;
+  struct filter filter;
+  struct network network;
+  struct topology topology;
 
   struct trace trace;
 
@@ -140,6 +161,7 @@ void flush_large_clause_occurrences (struct ruler *);
 
 void new_ruler_binary_clause (struct ruler *, unsigned, unsigned);
 void assign_ruler_unit (struct ruler *, unsigned unit);
+bool export_ruler_unit (struct ring *, unsigned unit);
 
 void connect_large_clause (struct ruler *, struct clause *);
 
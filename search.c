@@ -44,7 +44,7 @@ bool backtrack_propagate_iterate (struct ring *ring) {
   if (ring->level)
     backtrack (ring, 0);
   ring->trail.propagate = ring->trail.begin;
-  if (ring_propagate (ring, true, 0)) {
+  if (search_propagate (ring)) {
     set_inconsistent (ring,
                       "failed propagation after root-level backtracking");
     return false;
@@ -121,7 +121,7 @@ int search (struct ring *ring) {
   start_search (ring);
   int res = ring->inconsistent ? 20 : 0;
   while (!res) {
-    struct watch *conflict = ring_propagate (ring, true, 0);
+    struct watch *conflict = search_propagate (ring);
     if (conflict) {
       if (!analyze (ring, conflict))
         res = 20;
@@ -0,0 +1,63 @@
+#include "simd.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+#ifdef GIMSATUL_HAS_AVX2
+
+#include <immintrin.h>
+
+bool has_simd_support (void) {
+  __builtin_cpu_init ();
+  return __builtin_cpu_supports ("avx2");
+}
+
+// Gathers the values of eight literals at once by loading the four bytes
+// starting at the value of each literal, masks out the two watched
+// literals and then determines the first literal which is not false.  The
+// remaining less than eight literals are checked one-by-one.
+
+__attribute__ ((target ("avx2"))) unsigned *
+simd_find_non_false_literal (signed char *values, unsigned *begin,
+                             unsigned *end, unsigned not_lit,
+                             unsigned other) {
+  const __m256i not_lits = _mm256_set1_epi32 ((int) not_lit);
+  const __m256i others = _mm256_set1_epi32 ((int) other);
+  const __m256i false_values = _mm256_set1_epi32 (-1);
+  unsigned *p = begin;
+  while (end - p >= 8) {
+    __m256i lits = _mm256_loadu_si256 ((__m256i *) p);
+    __m256i words = _mm256_i32gather_epi32 ((const int *) values, lits, 1);
+    __m256i lit_values =
+        _mm256_srai_epi32 (_mm256_slli_epi32 (words, 24), 24);
+    __m256i non_false = _mm256_cmpgt_epi32 (lit_values, false_values);
+    __m256i watched = _mm256_or_si256 (_mm256_cmpeq_epi32 (lits, not_lits),
+                                       _mm256_cmpeq_epi32 (lits, others));
+    __m256i candidates = _mm256_andnot_si256 (watched, non_false);
+    int mask = _mm256_movemask_ps (_mm256_castsi256_ps (candidates));
+    if (mask)
+      return p + __builtin_ctz (mask);
+    p += 8;
+  }
+  while (p != end) {
+    unsigned lit = *p;
+    if (lit != not_lit && lit != other && values[lit] >= 0)
+      break;
+    p++;
+  }
+  return p;
+}
+
+#else
+
+bool has_simd_support (void) { return false; }
+
+unsigned *simd_find_non_false_literal (signed char *values, unsigned *begin,
+                                       unsigned *end, unsigned not_lit,
+                                       unsigned other) {
+  (void) values, (void) begin, (void) not_lit, (void) other;
+  assert (!"vectorized replacement search not supported");
+  return end;
+}
+
+#endif
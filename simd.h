@@ -0,0 +1,24 @@
+#ifndef _simd_h_INCLUDED
+#define _simd_h_INCLUDED
+
+#include "geatures.h"
+
+#include <stdbool.h>
+
+// The vectorized replacement search gathers four bytes of 'values' for
+// each literal.  Thus 'values' needs this many additional readable bytes
+// after its last element.
+
+#define VALUES_PADDING 3
+
+// Vectorize only when at least that many literals are to be searched.
+
+#define MIN_SIMD_LITERALS 8
+
+bool has_simd_support (void);
+
+unsigned *simd_find_non_false_literal (signed char *values, unsigned *begin,
+                                       unsigned *end, unsigned not_lit,
+                                       unsigned other);
+
+#endif
@@ -1,5 +1,6 @@
 #include "simplify.h"
 #include "backtrack.h"
+#include "bva.h"
 #include "clone.h"
 #include "compact.h"
 #include "deduplicate.h"
@@ -62,7 +63,8 @@ void add_resolvent (struct simplifier *simplifier) {
     assert (size > 2);
     if (ruler->eliminating)
       ruler->statistics.ticks.elimination += size;
-    struct clause *clause = new_large_clause (size, literals, false, 0);
+    struct clause *clause =
+        new_large_clause (ruler->arenas, size, literals, false, 0);
     connect_large_clause (ruler, clause);
     mark_subsume_clause (simplifier, clause);
     PUSH (ruler->clauses, clause);
@@ -268,7 +270,7 @@ delete_large_garbage_ruler_clauses (struct simplifier *simplifier) {
     struct clause *clause = *q++ = *p++;
     if (clause->garbage) {
       ROGCLAUSE (clause, "finally deleting");
-      free (clause);
+      deallocate_clause (ruler->arenas, clause);
 #ifndef QUIET
       deleted++;
 #endif
@@ -297,6 +299,7 @@ delete_large_garbage_ruler_clauses (struct simplifier *simplifier) {
       assert (1 < new_size);
       assert (new_size < old_size);
       clause->size = new_size;
+      update_signature (clause);
       clause->dirty = false;
       ROGCLAUSE (clause, "shrunken dirty");
       if (trace) {
@@ -316,7 +319,7 @@ delete_large_garbage_ruler_clauses (struct simplifier *simplifier) {
         new_ruler_binary_clause (ruler, lit, other);
         mark_subsume_literal (simplifier, other);
         mark_subsume_literal (simplifier, lit);
-        free (clause);
+        deallocate_clause (ruler->arenas, clause);
         q--;
       }
     }
@@ -433,6 +436,19 @@ static void set_ruler_limits (struct ruler *ruler) {
                " ticks after %" PRIu64,
                limit, boosted);
     }
+
+    {
+      uint64_t base = 1e6 * ruler->options.bva_ticks;
+      uint64_t delta = multiply_saturated (scale10, base, UINT64_MAX);
+      uint64_t boosted = multiply_saturated (boost, delta, UINT64_MAX);
+      uint64_t current = statistics->ticks.bva;
+      uint64_t limit = add_saturated (current, boosted, UINT64_MAX);
+      limits->bva = limit;
+      verbose (0,
+               "setting variable addition limit to %" PRIu64
+               " ticks after %" PRIu64,
+               limit, boosted);
+    }
   }
 
   {
@@ -519,6 +535,7 @@ static void push_ruler_units_to_extension_stack (struct ruler *ruler) {
   }
   verbose (0, "pushed %zu units on extension stack", pushed);
   ruler->units.end = ruler->units.propagate = ruler->units.begin;
+  ruler->units.reserved = 0;
 }
 
 static void
@@ -587,6 +604,13 @@ static void run_full_blown_simplification (struct simplifier *simplifier) {
     if (ruler->terminate)
       break;
 
+    if (bounded_variable_addition (simplifier, round))
+      complete = false;
+    if (!propagate_and_flush_ruler_units (simplifier))
+      break;
+    if (ruler->terminate)
+      break;
+
     if (eliminate_variables (simplifier, round))
       complete = false;
     if (!propagate_and_flush_ruler_units (simplifier))
@@ -600,12 +624,20 @@ static void run_full_blown_simplification (struct simplifier *simplifier) {
 #ifndef QUIET
   message (0, 0);
   after.variables = statistics->active;
-  assert (after.variables <= before.variables);
-  delta.variables = before.variables - after.variables;
 
-  message (0, "removed %zu variables %.0f%% with %zu remaining %.0f%%",
-           delta.variables, percent (delta.variables, before.variables),
-           after.variables, percent (after.variables, ruler->size));
+  if (after.variables <= before.variables) {
+    delta.variables = before.variables - after.variables;
+    message (0, "removed %zu variables %.0f%% with %zu remaining %.0f%%",
+             delta.variables, percent (delta.variables, before.variables),
+             after.variables, percent (after.variables, ruler->size));
+  } else {
+    delta.variables = after.variables - before.variables;
+    message (0,
+             "simplification ADDED %zu variables %.0f%% "
+             "with %zu remaining %.0f%%",
+             delta.variables, percent (delta.variables, before.variables),
+             after.variables, percent (after.variables, ruler->size));
+  }
 
   after.clauses = current_ruler_clauses (ruler);
   size_t original = statistics->original;
@@ -730,19 +762,14 @@ static bool continue_importing_and_propagating_units (struct ring *ring) {
     return false;
   if (ruler->winner)
     return false;
-  if (pthread_mutex_lock (&ruler->locks.units))
-    fatal_error ("failed to acquire units lock during "
-                 "simplification preparation");
   bool done = true;
-  unsigned *ruler_units_end = ruler->units.end;
+  unsigned *ruler_units_end =
+      atomic_load_explicit (&ruler->units.end, memory_order_acquire);
   for (all_rings (ring))
     if (ring->ruler_units != ruler_units_end) {
       done = false;
       break;
     }
-  if (pthread_mutex_unlock (&ruler->locks.units))
-    fatal_error ("failed to release units lock during "
-                 "simplification preparation");
   return !done;
 }
 
@@ -757,10 +784,11 @@ static bool synchronize_exported_and_imported_units (struct ring *ring) {
   while (continue_importing_and_propagating_units (ring))
     if (import_shared (ring))
       if (!ring->inconsistent)
-        if (ring_propagate (ring, false, 0))
+        if (probing_propagate (ring))
           set_inconsistent (ring, "propagation after importing failed");
 
   assert (ring->inconsistent || ring->trail.propagate == ring->trail.end);
+  reconcile_deferred_dereferences (ring);
 
   return !ring->inconsistent;
 }
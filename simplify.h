@@ -15,6 +15,10 @@ struct simplifier {
   bool *eliminated;
   struct unsigneds resolvent;
   struct clauses gate[2], nogate[2];
+  uint64_t ticks;
+  struct {
+    uint64_t checked, filtered;
+  } signatures;
 };
 
 /*------------------------------------------------------------------------*/
@@ -77,7 +81,8 @@ subsumption_ticks_limit_hit (struct simplifier *simplifier) {
   struct ruler *ruler = simplifier->ruler;
   struct ruler_statistics *statistics = &ruler->statistics;
   struct ruler_limits *limits = &ruler->limits;
-  return statistics->ticks.subsumption > limits->subsumption;
+  uint64_t ticks = statistics->ticks.subsumption + simplifier->ticks;
+  return ticks > limits->subsumption;
 }
 
 static inline bool
@@ -85,7 +90,8 @@ elimination_ticks_limit_hit (struct simplifier *simplifier) {
   struct ruler *ruler = simplifier->ruler;
   struct ruler_statistics *statistics = &ruler->statistics;
   struct ruler_limits *limits = &ruler->limits;
-  return statistics->ticks.elimination > limits->elimination;
+  uint64_t ticks = statistics->ticks.elimination + simplifier->ticks;
+  return ticks > limits->elimination;
 }
 
 #endif
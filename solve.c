@@ -1,8 +1,11 @@
 #include "solve.h"
+#include "exchange.h"
 #include "message.h"
+#include "network.h"
 #include "ruler.h"
 #include "scale.h"
 #include "search.h"
+#include "topology.h"
 
 #include <inttypes.h>
 #include <math.h>
@@ -16,11 +19,21 @@ static void *solve_routine (void *ptr) {
   return ring;
 }
 
+// Rings are pinned by their own thread before doing anything else, so
+// memory first touched while solving is allocated close to their CPU.
+
+static void *pin_and_solve_routine (void *ptr) {
+  pin_ring (ptr);
+  return solve_routine (ptr);
+}
+
 static void start_running_ring (struct ring *ring) {
   struct ruler *ruler = ring->ruler;
   assert (ruler->threads);
   pthread_t *thread = ruler->threads + ring->id;
-  if (pthread_create (thread, 0, solve_routine, ring))
+  void *(*routine) (void *) =
+      ruler->options.pin ? pin_and_solve_routine : solve_routine;
+  if (pthread_create (thread, 0, routine, ring))
     fatal_error ("failed to create solving thread %u", ring->id);
 #ifndef __APPLE__
   int sched_getcpu (void);
@@ -161,11 +174,19 @@ struct ring *solve_rings (struct ruler *ruler) {
   }
   for (all_rings (ring))
     set_ring_limits (ring, conflicts);
+  bool distributed = ruler->options.listen || ruler->options.connect;
+  if (ruler->options.exchange || distributed)
+    attach_exchange (ruler);
+  if (distributed)
+    start_network (ruler);
   message (0, 0);
   if (threads > 1) {
     for (all_rings (ring))
       ring->probe = ring->id * (ruler->compact / threads);
 
+    if (ruler->options.pin || ruler->options.export == 4)
+      init_topology (ruler);
+
     message (0, "starting and running %zu ring threads", threads);
 
 #define BARRIER(NAME) init_barrier (&ruler->barriers.NAME, #NAME, threads);
@@ -185,6 +206,7 @@ struct ring *solve_rings (struct ruler *ruler) {
     struct ring *ring = first_ring (ruler);
     (void) solve_routine (ring);
   }
+  stop_network (ruler);
   assert (ruler->solving);
   ruler->solving = false;
 #ifndef QUIET
@@ -1,6 +1,7 @@
 #ifndef QUIET
 
 #include "statistics.h"
+#include "arena.h"
 #include "message.h"
 #include "ruler.h"
 #include "tiers.h"
@@ -20,9 +21,11 @@ void print_ring_statistics (struct ring *ring) {
   uint64_t propagations = c->propagations;
   uint64_t jumped = c->jumped;
 #ifdef METRICS
-  uint64_t visits = 0;
+  uint64_t visits = 0, inlined = 0;
   for (unsigned i = 0; i != SIZE_VISITS; i++)
     visits += c->visits[i];
+  for (unsigned i = 1; i <= SIZE_WATCHER_LITERALS; i++)
+    inlined += c->visits[i];
 #endif
   unsigned variables = ring->ruler->size;
   PRINTLN ("%-22s %17" PRIu64 " %13.2f per second", "conflicts:", conflicts,
@@ -71,6 +74,18 @@ void print_ring_statistics (struct ring *ring) {
     PRINTLN ("%-22s %17" PRIu64 " %13.2f %% fixed",
              "  exported-units:", s->exported.units,
              percent (s->exported.units, s->fixed));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% exported",
+             "  unit-races:", s->units.races,
+             percent (s->units.races, s->exported.units));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% exported",
+             "  unit-waiting:", s->units.waiting,
+             percent (s->units.waiting, s->exported.units));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f per waiting",
+             "  unit-spins:", s->units.spins,
+             average (s->units.spins, s->units.waiting));
+    PRINTLN ("%-22s %17.6f %13.2f %% search time",
+             "  unit-waited:", s->units.waited,
+             percent (s->units.waited, search));
   }
 
   PRINTLN ("%-22s %17" PRIu64 " %13.2f thousands per second",
@@ -135,10 +150,11 @@ void print_ring_statistics (struct ring *ring) {
              percent (s->NAME.tier3, s->NAME.clauses)); \
     PRINT_CLAUSE_METRICS (NAME); \
   } while (0)
-#define MACRO(SIZE, NAME) \
+#define GLUE_MACRO(SIZE, NAME) \
   PRINTLN ("%-22s %17" PRIu64 " %13.2f %% " #NAME " clauses", \
            "  " #NAME "-glue" #SIZE ":", s->NAME.glue[SIZE], \
            percent (s->NAME.glue[SIZE], s->NAME.clauses))
+#define MACRO GLUE_MACRO
   PRINTLN ("%-22s %17" PRIu64 " %13.2f per second",
            "learned-clauses:", s->learned.clauses,
            average (s->learned.clauses, search));
@@ -184,6 +200,22 @@ void print_ring_statistics (struct ring *ring) {
   PRINTLN ("%-22s %17" PRIu64 " %13.2f millions per second",
            "propagations:", propagations,
            average (propagations, 1e6 * search));
+  PRINTLN ("%-22s %17" PRIu64 " %13.2f millions per second",
+           "search-ticks:", c->ticks, average (c->ticks, 1e6 * search));
+  if (ring->options.trail_saving) {
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f per conflict",
+             "trail-saved:", s->trail.saved,
+             average (s->trail.saved, conflicts));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% saved",
+             "  trail-reused:", s->trail.reused,
+             percent (s->trail.reused, s->trail.saved));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% propagations",
+             "  trail-replayed:", s->trail.reused,
+             percent (s->trail.reused, propagations));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% search ticks",
+             "  trail-ticks:", s->trail.ticks,
+             percent (s->trail.ticks, c->ticks));
+  }
 #ifdef METRICS
   PRINTLN ("%-22s %17" PRIu64 " %13.2f per propagation", "visits:", visits,
            average (visits, propagations));
@@ -191,10 +223,16 @@ void print_ring_statistics (struct ring *ring) {
 #define MACRO(SIZE, DUMMY) \
   PRINTLN ("%-22s %17" PRIu64 " %13.2f %% visits", "  visits" #SIZE ":", \
            c->visits[SIZE], percent (c->visits[SIZE], visits))
-  INSTANTIATE (SIZE_WATCHER_LITERALS + 1, SIZE_VISITS - 1);
+  INSTANTIATE (3, SIZE_VISITS - 1);
 #undef MACRO
+#define MACRO GLUE_MACRO
   PRINTLN ("%-22s %17" PRIu64 " %13.2f %% visits",
            "  visits-large:", c->visits[0], percent (c->visits[0], visits));
+  PRINTLN ("%-22s %17" PRIu64 " %13.2f %% visits",
+           "  visits-aux:", inlined, percent (inlined, visits));
+  PRINTLN ("%-22s %17" PRIu64 " %13.2f %% visits",
+           "  visits-clause:", visits - inlined,
+           percent (visits - inlined, visits));
 #endif
 
   PRINTLN ("%-22s %17" PRIu64 " %13.2f conflict interval",
@@ -216,6 +254,47 @@ void print_ring_statistics (struct ring *ring) {
            "  reduced-tier3:", s->reduced.tier3,
            percent (s->reduced.tier3, s->reduced.clauses));
 
+  {
+    struct arena_statistics *a = &ring->arena->statistics;
+    PRINTLN ("%-22s %17zu %13.2f MB", "arena-chunks:", a->chunks,
+             a->bytes / (double) (1 << 20));
+    PRINTLN ("%-22s %17zu %13.2f %% chunk bytes",
+             "  arena-occupancy:", a->live, percent (a->live, a->bytes));
+    PRINTLN ("%-22s %17zu %13.2f %% chunk bytes",
+             "  arena-fragmentation:", a->free,
+             percent (a->free, a->bytes));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f per second",
+             "  arena-allocated:", a->allocated,
+             average (a->allocated, search));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% allocated",
+             "  arena-reused:", a->reused,
+             percent (a->reused, a->allocated));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% allocated",
+             "  arena-large:", a->large, percent (a->large, a->allocated));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% deallocated",
+             "  arena-remote:", a->remote,
+             percent (a->remote, a->deallocated));
+  }
+
+  {
+    struct vectors *v = &ring->vectors;
+    size_t bytes = CAPACITY (*v) * sizeof *v->begin;
+    size_t wasted = v->wasted * sizeof *v->begin;
+    PRINTLN ("%-22s %17zu %13.2f MB", "watch-arena:", bytes,
+             bytes / (double) (1 << 20));
+    PRINTLN ("%-22s %17zu %13.2f %% arena bytes", "  watch-wasted:", wasted,
+             percent (wasted, bytes));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f conflict interval",
+             "  watch-defrags:", v->statistics.defragmentations,
+             average (conflicts, v->statistics.defragmentations));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f per second",
+             "  watch-moved:", v->statistics.moved,
+             average (v->statistics.moved, search));
+    PRINTLN ("%-22s %17" PRIu64 " %13.2f %% moved",
+             "  watch-enlarged:", v->statistics.enlarged,
+             percent (v->statistics.enlarged, v->statistics.moved));
+  }
+
   if (ring->pool) {
     PRINTLN ("%-22s %17" PRIu64 " %13.2f %% learned clauses",
              "imported-clauses:", s->imported.clauses,
@@ -224,6 +303,14 @@ void print_ring_statistics (struct ring *ring) {
              "  diverged-imports:", s->diverged,
              percent (s->diverged, s->imported.clauses));
     PRINT_CLAUSE_STATISTICS (imported);
+    if (ring->options.import_batch) {
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f clauses per batch",
+               "  import-batches:", s->batched.batches,
+               average (s->batched.clauses, s->batched.batches));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f per batch",
+               "  import-ticks:", s->batched.ticks,
+               average (s->batched.ticks, s->batched.batches));
+    }
 
     {
       uint64_t subsumed =
@@ -240,12 +327,78 @@ void print_ring_statistics (struct ring *ring) {
           "%-22s %17" PRIu64 " %13.2f %% checked clauses",
           "  subsumed-large:", s->subsumed.large.succeeded,
           percent (s->subsumed.large.succeeded, s->subsumed.large.checked));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% signature checks",
+               "  signature-filtered:", s->subsumed.signatures.filtered,
+               percent (s->subsumed.signatures.filtered,
+                        s->subsumed.signatures.checked));
     }
 
     PRINTLN ("%-22s %17" PRIu64 " %13.2f %% learned clauses",
              "exported-clauses:", s->exported.clauses,
              percent (s->exported.clauses, s->learned.clauses));
     PRINT_CLAUSE_STATISTICS (exported);
+
+    if (ring->ruler->store.chunks) {
+      uint64_t added = s->stored.added;
+      uint64_t duplicated = s->stored.duplicated;
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% learned clauses",
+               "stored-binaries:", added,
+               percent (added, s->learned.clauses));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% stored",
+               "  store-duplicates:", duplicated,
+               percent (duplicated, added + duplicated));
+    }
+
+    {
+      uint64_t exported = 0, dropped = 0, overwritten = 0, imported = 0;
+      uint64_t resized = 0, capacity = 0, throttled = 0;
+      for (unsigned i = 0; i != ring->threads; i++) {
+        if (i == ring->id)
+          continue;
+        struct pool *p = ring->pool + i;
+        exported += p->exported;
+        dropped += p->dropped;
+        overwritten += p->overwritten;
+        imported += p->imported;
+        resized += p->resized;
+        capacity += p->capacity;
+        throttled += p->throttled;
+      }
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f per receiver",
+               "pooled-clauses:", exported,
+               average (exported, ring->threads - 1));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% pooled",
+               "  pool-dropped:", dropped, percent (dropped, exported));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% pooled",
+               "  pool-overwritten:", overwritten,
+               percent (overwritten, exported));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% pooled",
+               "  pool-imported:", imported, percent (imported, exported));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f average capacity",
+               "  pool-resized:", resized,
+               average (capacity, ring->threads - 1));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% pooled",
+               "  pool-throttled:", throttled,
+               percent (throttled, exported));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f per batch",
+               "deferred-dereferences:", s->deferred.dereferences,
+               average (s->deferred.dereferences, s->deferred.batches));
+      PRINTLN ("%-22s %17" PRIu64 " %13.2f %% deferred",
+               "  reconciled:", s->deferred.reconciled,
+               percent (s->deferred.reconciled, s->deferred.dereferences));
+      if (verbosity > 0)
+        for (unsigned i = 0; i != ring->threads; i++) {
+          if (i == ring->id)
+            continue;
+          struct pool *p = ring->pool + i;
+          uint64_t imported = p->imported;
+          PRINTLN ("  pool-to-%u: %" PRIu64 " pooled %" PRIu64
+                   " dropped %" PRIu64 " overwritten %" PRIu64
+                   " imported %u capacity",
+                   i, p->exported, p->dropped, p->overwritten, imported,
+                   (unsigned) p->capacity);
+        }
+    }
   }
 
   PRINTLN ("%-22s %17" PRIu64 " %13.2f conflict interval",
@@ -302,8 +455,53 @@ void print_ruler_statistics (struct ruler *ruler) {
           "simplifications:", s->simplifications);
   printf ("c %-22s %17" PRIu64 " %13.2f %% original clauses\n",
           "subsumed:", s->subsumed, percent (s->subsumed, s->original));
+  printf ("c %-22s %17" PRIu64 " %13.2f %% signature checks\n",
+          "  signature-filtered:", s->signatures.filtered,
+          percent (s->signatures.filtered, s->signatures.checked));
   printf ("c %-22s %17zu %13.2f %% original clauses\n",
           "weakened:", s->weakened, percent (s->weakened, s->original));
+  if (ruler->fresh) {
+    printf ("c %-22s %17u %13.2f %% variables\n",
+            "added:", ruler->fresh, percent (ruler->fresh, variables));
+    printf ("c %-22s %17" PRIu64 " %13.2f %% original clauses\n",
+            "  added-replaced:", s->bva.replaced,
+            percent (s->bva.replaced, s->original));
+    printf ("c %-22s %17" PRIu64 " %13.2f %% original clauses\n",
+            "  added-reduced:", s->bva.reduced,
+            percent (s->bva.reduced, s->original));
+  }
+  if (ruler->filter.table) {
+    uint64_t checked = 0, duplicates = 0;
+    for (all_rings (ring)) {
+      checked += ring->statistics.filter.checked;
+      duplicates += ring->statistics.filter.duplicates;
+    }
+    printf ("c %-22s %17" PRIu64 " %13.2f per ring\n", "filtered:",
+            checked, average (checked, SIZE (ruler->rings)));
+    printf ("c %-22s %17" PRIu64 " %13.2f %% filtered clauses\n",
+            "  filter-duplicates:", duplicates,
+            percent (duplicates, checked));
+  }
+  if (ruler->exchange.segment) {
+    uint64_t exported = 0, imported = 0, lost = 0, unmapped = 0;
+    for (all_rings (ring)) {
+      exported += ring->statistics.exchanged.exported;
+      imported += ring->statistics.exchanged.imported;
+      lost += ring->statistics.exchanged.lost;
+      unmapped += ring->statistics.exchanged.unmapped;
+    }
+    uint64_t read = imported + unmapped;
+    printf ("c %-22s %17" PRIu64 " %13.2f per ring\n",
+            "exchange-exported:", exported,
+            average (exported, SIZE (ruler->rings)));
+    printf ("c %-22s %17" PRIu64 " %13.2f %% read clauses\n",
+            "exchange-imported:", imported, percent (imported, read));
+    printf ("c %-22s %17" PRIu64 " %13.2f %% read clauses\n",
+            "exchange-unmapped:", unmapped, percent (unmapped, read));
+    printf ("c %-22s %17" PRIu64 " %13.2f per ring\n", "exchange-lost:",
+            lost, average (lost, SIZE (ruler->rings)));
+  }
+  print_network_statistics (ruler);
   printf ("c %-22s %17u %13.2f %% total-fixed\n",
           "simplifying-fixed:", s->fixed.simplifying,
           percent (s->fixed.simplifying, s->fixed.total));
@@ -314,6 +512,27 @@ void print_ruler_statistics (struct ruler *ruler) {
           "total-fixed:", s->fixed.total,
           percent (s->fixed.total, variables));
 
+  unsigned threads = SIZE (ruler->rings);
+  if (threads > 1 && ruler->options.import_feedback &&
+      (threads <= 16 || verbosity > 0)) {
+    printf ("c\nc usefulness (bumped per imported clause) of source "
+            "ring (columns) for importing ring (rows):\nc\nc     ");
+    for (unsigned src = 0; src != threads; src++)
+      printf (" %6u", src);
+    fputc ('\n', stdout);
+    for (all_rings (ring)) {
+      printf ("c %3u ", ring->id);
+      for (unsigned src = 0; src != threads; src++)
+        if (src == ring->id)
+          printf ("      -");
+        else {
+          struct source *s = ring->sources + src;
+          printf (" %6.2f", average (s->used, s->imported));
+        }
+      fputc ('\n', stdout);
+    }
+  }
+
   printf ("c\n");
 
   printf ("c %-30s %23.2f %%\n", "utilization:",
@@ -3,6 +3,7 @@
 
 #include "options.h"
 
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -68,6 +69,48 @@ struct ring_statistics {
   size_t irredundant;
   size_t redundant;
 
+  struct {
+    uint64_t saved;
+    uint64_t reused;
+    uint64_t ticks;
+  } trail;
+
+  struct {
+    uint64_t checked;
+    uint64_t duplicates;
+  } filter;
+
+  struct {
+    uint64_t exported;
+    uint64_t imported;
+    uint64_t lost;
+    uint64_t unmapped;
+  } exchanged;
+
+  struct {
+    uint64_t batches;
+    uint64_t dereferences;
+    uint64_t reconciled;
+  } deferred;
+
+  struct {
+    uint64_t added;
+    uint64_t duplicated;
+  } stored;
+
+  struct {
+    uint64_t batches;
+    uint64_t clauses;
+    uint64_t ticks;
+  } batched;
+
+  struct {
+    uint64_t races;
+    uint64_t spins;
+    uint64_t waiting;
+    double waited;
+  } units;
+
   struct {
     uint64_t units;
     uint64_t tried;
@@ -128,6 +171,10 @@ struct ring_statistics {
       uint64_t checked;
       uint64_t succeeded;
     } binary, large;
+    struct {
+      uint64_t checked;
+      uint64_t filtered;
+    } signatures;
   } subsumed;
 
   uint64_t eagerly_subsumed;
@@ -211,7 +258,7 @@ struct ring_statistics {
 struct ruler_statistics {
   uint64_t garbage;
   uint64_t binaries;
-  unsigned active;
+  atomic_uint active;
   unsigned original;
   uint64_t deduplicated;
   unsigned eliminated;
@@ -223,13 +270,22 @@ struct ruler_statistics {
   uint64_t simplifications;
   size_t weakened;
   struct {
+    uint64_t replaced;
+    uint64_t reduced;
+  } bva;
+  struct {
+    uint64_t bva;
     uint64_t elimination;
     uint64_t subsumption;
   } ticks;
   struct {
-    unsigned simplifying;
-    unsigned solving;
-    unsigned total;
+    uint64_t checked;
+    uint64_t filtered;
+  } signatures;
+  struct {
+    atomic_uint simplifying;
+    atomic_uint solving;
+    atomic_uint total;
   } fixed;
 };
 
@@ -0,0 +1,271 @@
+#include "store.h"
+#include "allocate.h"
+#include "message.h"
+#include "ruler.h"
+#include "utilities.h"
+
+#include <string.h>
+
+static struct store_chunk *new_store_chunk (void) {
+  struct store_chunk *chunk = allocate_block (sizeof *chunk);
+  atomic_init (&chunk->next, 0);
+  atomic_init (&chunk->size, 0);
+  for (unsigned i = 0; i != SIZE_STORE_CHUNK; i++)
+    atomic_init (chunk->others + i, INVALID);
+  return chunk;
+}
+
+static struct store_log *new_store_log (void) {
+  return allocate_and_clear_block (sizeof (struct store_log));
+}
+
+void init_store (struct ruler *ruler) {
+  struct store *store = &ruler->store;
+  store->chunks =
+      allocate_and_clear_array (2 * ruler->size, sizeof *store->chunks);
+  store->recent = allocate_and_clear_array (
+      (size_t) 1 << LOG2_SIZE_STORE_RECENT, sizeof *store->recent);
+  store->first = new_store_log ();
+  atomic_init (&store->last, store->first);
+}
+
+static void release_store_chunks_and_logs (struct ruler *ruler) {
+  struct store *store = &ruler->store;
+  unsigned variables = ruler->size + ruler->fresh;
+  for (unsigned lit = 0; lit != 2 * variables; lit++) {
+    struct store_chunk *next;
+    for (struct store_chunk *chunk = store->chunks[lit]; chunk;
+         chunk = next) {
+      next = chunk->next;
+      free (chunk);
+    }
+    store->chunks[lit] = 0;
+  }
+  struct store_log *next;
+  for (struct store_log *log = store->first; log; log = next) {
+    next = log->next;
+    free (log);
+  }
+  store->first = 0;
+}
+
+void release_store (struct ruler *ruler) {
+  struct store *store = &ruler->store;
+  if (!store->chunks)
+    return;
+  release_store_chunks_and_logs (ruler);
+  free (store->chunks);
+  free (store->recent);
+  store->chunks = 0;
+  store->recent = 0;
+}
+
+void init_store_cursor (struct ring *ring) {
+  struct store *store = &ring->ruler->store;
+  ring->stored.log = store->first;
+  ring->stored.position = 0;
+}
+
+// Lookup and insertion of the pair are combined into one atomic exchange.
+// Pairs hashed to the same entry overwrite each other, so only duplicates
+// of recently added binary clauses are found, but in constant time.
+
+static bool stored_binary (struct store *store, uint64_t pair) {
+  uint64_t hash = pair * 0x9e3779b97f4a7c15ull;
+  size_t pos = hash >> (64 - LOG2_SIZE_STORE_RECENT);
+  atomic_uint_fast64_t *entry = store->recent + pos;
+  return atomic_load_explicit (entry, memory_order_relaxed) == pair ||
+         atomic_exchange_explicit (entry, pair, memory_order_relaxed) ==
+             pair;
+}
+
+static void append_stored_literal (struct store *store, unsigned lit,
+                                   unsigned other) {
+  _Atomic (struct store_chunk *) *link = store->chunks + lit;
+  for (;;) {
+    struct store_chunk *chunk =
+        atomic_load_explicit (link, memory_order_acquire);
+    if (!chunk) {
+      struct store_chunk *fresh = new_store_chunk ();
+      if (!atomic_compare_exchange_strong_explicit (
+              link, &chunk, fresh, memory_order_release,
+              memory_order_acquire))
+        free (fresh);
+      continue;
+    }
+    if (atomic_load_explicit (&chunk->size, memory_order_relaxed) <
+        SIZE_STORE_CHUNK) {
+      unsigned slot = atomic_fetch_add_explicit (&chunk->size, 1,
+                                                 memory_order_relaxed);
+      if (slot < SIZE_STORE_CHUNK) {
+        atomic_store_explicit (chunk->others + slot, other,
+                               memory_order_release);
+        return;
+      }
+    }
+    link = &chunk->next;
+  }
+}
+
+static void append_stored_pair (struct store *store, unsigned source,
+                                uint64_t pair) {
+  assert (pair);
+  for (;;) {
+    struct store_log *log =
+        atomic_load_explicit (&store->last, memory_order_acquire);
+    if (atomic_load_explicit (&log->size, memory_order_relaxed) <
+        SIZE_STORE_LOG) {
+      unsigned slot =
+          atomic_fetch_add_explicit (&log->size, 1, memory_order_relaxed);
+      if (slot < SIZE_STORE_LOG) {
+        log->sources[slot] = source;
+        atomic_store_explicit (log->pairs + slot, pair,
+                               memory_order_release);
+        return;
+      }
+    }
+    struct store_log *next =
+        atomic_load_explicit (&log->next, memory_order_acquire);
+    if (!next) {
+      struct store_log *fresh = new_store_log ();
+      if (atomic_compare_exchange_strong_explicit (
+              &log->next, &next, fresh, memory_order_release,
+              memory_order_acquire))
+        next = fresh;
+      else
+        free (fresh);
+    }
+    (void) atomic_compare_exchange_strong_explicit (
+        &store->last, &log, next, memory_order_release,
+        memory_order_relaxed);
+  }
+}
+
+static uint64_t stored_pair (unsigned lit, unsigned other) {
+  assert (lit < other);
+  return ((uint64_t) lit << 32) | other;
+}
+
+static void append_stored_binary (struct store *store, unsigned source,
+                                  unsigned lit, unsigned other) {
+  append_stored_literal (store, lit, other);
+  append_stored_literal (store, other, lit);
+  append_stored_pair (store, source, stored_pair (lit, other));
+}
+
+// Returns 'false' if the binary clause was recently added to the store.
+// Older duplicates are added again, which is harmless.
+
+bool add_stored_binary (struct ring *ring, unsigned lit, unsigned other) {
+  assert (lit != other);
+  if (lit > other)
+    SWAP (unsigned, lit, other);
+  struct store *store = &ring->ruler->store;
+  assert (store->chunks);
+  if (stored_binary (store, stored_pair (lit, other))) {
+    LOGBINARY (true, lit, other, "already stored");
+    ring->statistics.stored.duplicated++;
+    return false;
+  }
+  LOGBINARY (true, lit, other, "storing");
+  append_stored_binary (store, ring->id, lit, other);
+  ring->statistics.stored.added++;
+  return true;
+}
+
+// Moves the cursor of the ring to the next binary clause added by another
+// ring.  Returns 'false' if there is none (yet).
+
+bool next_stored_binary (struct ring *ring, unsigned *lit, unsigned *other,
+                         unsigned *source) {
+  struct store_cursor *cursor = &ring->stored;
+  struct store_log *log = cursor->log;
+  for (;;) {
+    unsigned position = cursor->position;
+    if (position == SIZE_STORE_LOG) {
+      struct store_log *next =
+          atomic_load_explicit (&log->next, memory_order_acquire);
+      if (!next)
+        return false;
+      cursor->log = log = next;
+      cursor->position = position = 0;
+    }
+    uint64_t pair =
+        atomic_load_explicit (log->pairs + position, memory_order_acquire);
+    if (!pair)
+      return false;
+    cursor->position = position + 1;
+    unsigned id = log->sources[position];
+    if (id == ring->id)
+      continue;
+    *lit = pair >> 32;
+    *other = (unsigned) pair;
+    *source = id;
+    return true;
+  }
+}
+
+static unsigned map_stored_literal (unsigned *map, unsigned lit) {
+  unsigned mapped = map[IDX (lit)];
+  if (mapped == INVALID)
+    return INVALID;
+  unsigned res = LIT (mapped);
+  if (SGN (lit))
+    res = NOT (res);
+  return res;
+}
+
+// Called while variables are renumbered and all rings are stopped.  Binary
+// clauses with eliminated or fixed variables are dropped.  All cursors are
+// moved to the end of the new log, since the rings propagate all (then
+// unassigned) literals from scratch after simplification anyhow.
+
+void compact_store (struct ruler *ruler, unsigned *map) {
+  struct store *store = &ruler->store;
+  if (!store->chunks)
+    return;
+  struct unsigneds mapped;
+  INIT (mapped);
+#ifndef QUIET
+  size_t stored = 0;
+#endif
+  for (struct store_log *log = store->first; log; log = log->next) {
+    unsigned size = atomic_load (&log->size);
+    if (size > SIZE_STORE_LOG)
+      size = SIZE_STORE_LOG;
+    for (unsigned i = 0; i != size; i++) {
+      uint64_t pair = atomic_load (log->pairs + i);
+      assert (pair);
+#ifndef QUIET
+      stored++;
+#endif
+      unsigned lit = map_stored_literal (map, pair >> 32);
+      if (lit == INVALID)
+        continue;
+      unsigned other = map_stored_literal (map, (unsigned) pair);
+      if (other == INVALID)
+        continue;
+      if (lit > other)
+        SWAP (unsigned, lit, other);
+      PUSH (mapped, lit);
+      PUSH (mapped, other);
+    }
+  }
+  release_store_chunks_and_logs (ruler);
+  memset (store->recent, 0,
+          ((size_t) 1 << LOG2_SIZE_STORE_RECENT) * sizeof *store->recent);
+  store->first = new_store_log ();
+  atomic_store (&store->last, store->first);
+  unsigned *end = mapped.end;
+  for (unsigned *p = mapped.begin; p != end; p += 2)
+    append_stored_binary (store, 0, p[0], p[1]);
+  verbose (0, "kept %zu stored binary clauses out of %zu",
+           SIZE (mapped) / 2, stored);
+  RELEASE (mapped);
+  struct store_log *last = atomic_load (&store->last);
+  unsigned position = atomic_load (&last->size);
+  for (all_rings (ring)) {
+    ring->stored.log = last;
+    ring->stored.position = position;
+  }
+}
@@ -0,0 +1,79 @@
+#ifndef _store_h_INCLUDED
+#define _store_h_INCLUDED
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Learned binary clauses are the only clauses which would otherwise be
+// physically copied into the watch lists of every ring importing them.
+// With '--binary-store' they are instead appended once to a global
+// lock-free store, which all rings scan during propagation in addition to
+// the shared irredundant binary clauses ('references->binaries').  For
+// each literal the store has a list of fixed size chunks of 'other'
+// literals.  Writers reserve a slot in the last chunk by incrementing its
+// 'size', allocate and link a new chunk if it is full, and then fill in
+// the reserved slot, which stays 'INVALID' until then.  Every binary
+// clause added is also appended to a global log of chunks, on which each
+// ring keeps a cursor to find binary clauses added by other rings since
+// the ring last looked and to repropagate them if necessary (as when
+// importing clauses).  Nothing is removed during search.  The store is
+// compacted (rebuilt from the log) when variables are renumbered during
+// simplification while all rings are stopped.  Since proof lines of
+// different rings might end up in the wrong order, it is not used with
+// proof tracing.  Duplicates are only detected through a fixed-size table
+// of recently added pairs, where each lookup is a single atomic exchange,
+// instead of scanning all chunks of a literal for every learned clause.
+
+#define SIZE_STORE_CHUNK 13
+#define SIZE_STORE_LOG 1024
+#define LOG2_SIZE_STORE_RECENT 16
+
+struct ring;
+struct ruler;
+
+struct store_chunk {
+  _Atomic (struct store_chunk *) next;
+  atomic_uint size;
+  atomic_uint others[SIZE_STORE_CHUNK];
+};
+
+struct store_log {
+  _Atomic (struct store_log *) next;
+  atomic_uint size;
+  atomic_uint_fast64_t pairs[SIZE_STORE_LOG];
+  unsigned short sources[SIZE_STORE_LOG];
+};
+
+struct store {
+  _Atomic (struct store_chunk *) *chunks;
+  atomic_uint_fast64_t *recent;
+  struct store_log *first;
+  _Atomic (struct store_log *) last;
+};
+
+struct store_cursor {
+  struct store_log *log;
+  unsigned position;
+};
+
+#define all_stored_chunks(CHUNK, CHUNKS, LIT) \
+  struct store_chunk *CHUNK = \
+      atomic_load_explicit ((CHUNKS) + (LIT), memory_order_acquire); \
+  CHUNK; \
+  CHUNK = atomic_load_explicit (&CHUNK->next, memory_order_acquire)
+
+static inline unsigned stored_chunk_size (struct store_chunk *chunk) {
+  unsigned size = atomic_load_explicit (&chunk->size, memory_order_relaxed);
+  return size < SIZE_STORE_CHUNK ? size : SIZE_STORE_CHUNK;
+}
+
+void init_store (struct ruler *);
+void release_store (struct ruler *);
+void compact_store (struct ruler *, unsigned *map);
+void init_store_cursor (struct ring *);
+
+bool add_stored_binary (struct ring *, unsigned lit, unsigned other);
+bool next_stored_binary (struct ring *, unsigned *lit, unsigned *other,
+                         unsigned *source);
+
+#endif
@@ -8,6 +8,8 @@
 #include "utilities.h"
 
 #include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <string.h>
 
 static bool is_subsumption_candidate (struct simplifier *simplifier,
@@ -57,6 +59,7 @@ static size_t get_subsumption_candidates (struct simplifier *simplifier,
 
 static struct clause *find_subsuming_clause (struct simplifier *simplifier,
                                              unsigned lit,
+                                             uint64_t signature,
                                              bool strengthen_only,
                                              unsigned *remove_ptr) {
   assert (!strengthen_only || marked_literal (simplifier->marks, lit) < 0);
@@ -64,7 +67,7 @@ static struct clause *find_subsuming_clause (struct simplifier *simplifier,
   struct ruler *ruler = simplifier->ruler;
   struct clauses *clauses = &OCCURRENCES (lit);
   size_t size_clauses = SIZE (*clauses);
-  ruler->statistics.ticks.subsumption++;
+  simplifier->ticks++;
   size_t occurrence_limit = ruler->limits.occurrence_limit;
   if (size_clauses > occurrence_limit)
     return 0;
@@ -74,7 +77,7 @@ static struct clause *find_subsuming_clause (struct simplifier *simplifier,
   struct clause **begin = clauses->begin;
   struct clause **end = clauses->end;
   struct clause **p = begin;
-  uint64_t ticks = 0;
+  uint64_t ticks = 0, checked = 0, filtered = 0;
   while (p != end) {
     assert (!res);
     struct clause *clause = *p++;
@@ -94,8 +97,13 @@ static struct clause *find_subsuming_clause (struct simplifier *simplifier,
       }
     } else {
       ticks++;
-      res = clause;
       assert (!clause->garbage);
+      checked++;
+      if (!subset_signature (clause->signature, signature)) {
+        filtered++;
+        continue;
+      }
+      res = clause;
       for (all_literals_in_clause (other, clause)) {
         if (other == lit)
           continue;
@@ -118,7 +126,9 @@ static struct clause *find_subsuming_clause (struct simplifier *simplifier,
     }
   }
   ticks += cache_lines (p, begin);
-  ruler->statistics.ticks.subsumption += ticks;
+  simplifier->ticks += ticks;
+  simplifier->signatures.checked += checked;
+  simplifier->signatures.filtered += filtered;
   if (res && resolved != INVALID)
     *remove_ptr = NOT (resolved);
   return res;
@@ -178,13 +188,46 @@ static void strengthen_very_large_clause (struct simplifier *simplifier,
   unsigned new_size = q - literals;
   assert (new_size + 1 == old_size);
   clause->size = new_size;
+  update_signature (clause);
   assert (new_size > 2);
   ruler->statistics.strengthened++;
   mark_subsume_clause (simplifier, clause);
 }
 
-static void forward_subsume_large_clause (struct simplifier *simplifier,
-                                          struct clause *clause) {
+static void connect_least_occurring_literal (struct ruler *ruler,
+                                             struct clause *clause) {
+  assert (!clause->garbage);
+  unsigned min_lit = INVALID;
+  unsigned min_size = UINT_MAX;
+  for (all_literals_in_clause (lit, clause)) {
+    unsigned lit_size = SIZE (OCCURRENCES (lit));
+    if (min_lit != INVALID && min_size <= lit_size)
+      continue;
+    min_lit = lit;
+    min_size = lit_size;
+  }
+  assert (min_lit != INVALID);
+  assert (min_size != INVALID);
+  if (min_size <= ruler->limits.occurrence_limit) {
+    ROGCLAUSE (clause,
+               "connecting least occurring literal %s "
+               "with %u occurrences in",
+               ROGLIT (min_lit), min_size);
+    connect_literal (ruler, min_lit, clause);
+  } else
+    ROGCLAUSE (clause,
+               "not connecting least occurring literal %s "
+               "with %u occurrences in",
+               ROGLIT (min_lit), min_size);
+}
+
+// Returns the candidate after strengthening (which is a binary clause
+// pointer if it was strengthened to a binary clause) or zero if it was
+// found to be subsumed.
+
+static struct clause *
+forward_subsume_large_clause (struct simplifier *simplifier,
+                              struct clause *clause) {
   struct ruler *ruler = simplifier->ruler;
   ROGCLAUSE (clause, "subsumption candidate");
   assert (!is_binary_pointer (clause));
@@ -198,13 +241,15 @@ REENTER:;
   unsigned remove = INVALID, other = INVALID;
   struct clause *subsuming = 0;
   for (all_literals_in_clause (lit, clause)) {
-    subsuming = find_subsuming_clause (simplifier, lit, false, &remove);
+    subsuming = find_subsuming_clause (simplifier, lit, clause->signature,
+                                       false, &remove);
     if (subsuming) {
       other = lit;
       break;
     }
     unsigned not_lit = NOT (lit);
-    subsuming = find_subsuming_clause (simplifier, not_lit, true, &remove);
+    subsuming = find_subsuming_clause (simplifier, not_lit,
+                                       clause->signature, true, &remove);
     if (subsuming) {
       other = not_lit;
       break;
@@ -256,39 +301,18 @@ REENTER:;
         goto REENTER;
       }
     }
-    if (!is_binary_pointer (clause)) {
-      assert (!clause->garbage);
-      unsigned min_lit = INVALID;
-      unsigned min_size = UINT_MAX;
-      for (all_literals_in_clause (lit, clause)) {
-        unsigned lit_size = SIZE (OCCURRENCES (lit));
-        if (min_lit != INVALID && min_size <= lit_size)
-          continue;
-        min_lit = lit;
-        min_size = lit_size;
-      }
-      assert (min_lit != INVALID);
-      assert (min_size != INVALID);
-      if (min_size <= ruler->limits.occurrence_limit) {
-        ROGCLAUSE (clause,
-                   "connecting least occurring literal %s "
-                   "with %u occurrences in",
-                   ROGLIT (min_lit), min_size);
-        connect_literal (ruler, min_lit, clause);
-      } else
-        ROGCLAUSE (clause,
-                   "not connecting least occurring literal %s "
-                   "with %u occurrences in",
-                   ROGLIT (min_lit), min_size);
-    }
+    if (!is_binary_pointer (clause))
+      connect_least_occurring_literal (ruler, clause);
   }
   if (is_binary_pointer (clause)) {
     unsigned lit = lit_pointer (clause);
     unsigned other = other_pointer (clause);
     unmark_literal (simplifier->marks, lit);
     unmark_literal (simplifier->marks, other);
-  } else
-    unmark_clause (simplifier->marks, clause, INVALID);
+    return clause;
+  }
+  unmark_clause (simplifier->marks, clause, INVALID);
+  return clause->garbage ? 0 : clause;
 }
 
 static void
@@ -304,7 +328,7 @@ flush_large_garbage_clauses_and_reconnect (struct ruler *ruler) {
     struct clause *clause = *q++ = *p++;
     if (clause->garbage) {
       ROGCLAUSE (clause, "finally deleting");
-      free (clause);
+      deallocate_clause (ruler->arenas, clause);
 #ifndef QUIET
       flushed++;
 #endif
@@ -321,6 +345,282 @@ flush_large_garbage_clauses_and_reconnect (struct ruler *ruler) {
   very_verbose (0, "reconnected %zu large clauses", reconnected);
 }
 
+/*------------------------------------------------------------------------*/
+
+// With more than one subsumption thread the sorted candidates are split
+// into chunks.  The candidates of a chunk are first checked concurrently
+// against the clauses connected before the chunk, which only reads the
+// occurrence lists.  Then the chunk is committed sequentially in order.
+// Candidates for which a subsuming or strengthening clause was found are
+// processed again by 'forward_subsume_large_clause' (since the found
+// clause might have become garbage in the meantime).  Candidates without
+// match are only processed again if one of the clauses added while
+// committing the same chunk subsumes or strengthens them, and otherwise
+// just connected.  This gives the same result as checking all candidates
+// sequentially, except for tick accounting.
+
+#define SUBSUMPTION_CHUNK 1024
+
+struct chunk {
+  struct clause **begin, **end;
+  atomic_size_t next;
+  bool *found;
+  uint64_t *ticks;
+  unsigned *stamps;
+  unsigned stamp;
+  struct clauses added;
+  size_t rechecked;
+};
+
+struct checker {
+  struct simplifier simplifier;
+  struct chunk *chunk;
+  size_t checked, found;
+  uint64_t ticks;
+};
+
+static void flush_subsumption_ticks (struct simplifier *simplifier) {
+  struct ruler *ruler = simplifier->ruler;
+  struct ruler_statistics *statistics = &ruler->statistics;
+  statistics->ticks.subsumption += simplifier->ticks;
+  statistics->signatures.checked += simplifier->signatures.checked;
+  statistics->signatures.filtered += simplifier->signatures.filtered;
+  simplifier->signatures.checked = simplifier->signatures.filtered = 0;
+  simplifier->ticks = 0;
+}
+
+static bool find_subsuming_or_strengthening_clause (
+    struct simplifier *simplifier, struct clause *clause) {
+  signed char *marks = simplifier->marks;
+  mark_clause (marks, clause, INVALID);
+  uint64_t signature = clause->signature;
+  unsigned remove = INVALID;
+  bool res = false;
+  for (all_literals_in_clause (lit, clause)) {
+    if (find_subsuming_clause (simplifier, lit, signature, false,
+                               &remove)) {
+      res = true;
+      break;
+    }
+    unsigned not_lit = NOT (lit);
+    if (find_subsuming_clause (simplifier, not_lit, signature, true,
+                               &remove)) {
+      res = true;
+      break;
+    }
+  }
+  unmark_clause (marks, clause, INVALID);
+  return res;
+}
+
+static void *check_subsumption_candidates (void *ptr) {
+  struct checker *checker = ptr;
+  struct simplifier *simplifier = &checker->simplifier;
+  struct chunk *chunk = checker->chunk;
+  size_t size = chunk->end - chunk->begin;
+  for (;;) {
+    size_t i =
+        atomic_fetch_add_explicit (&chunk->next, 1, memory_order_relaxed);
+    if (i >= size)
+      break;
+    struct clause *clause = chunk->begin[i];
+    assert (!simplifier->ticks);
+    bool found =
+        find_subsuming_or_strengthening_clause (simplifier, clause);
+    chunk->found[i] = found;
+    chunk->ticks[i] = simplifier->ticks;
+    checker->ticks += simplifier->ticks;
+    simplifier->ticks = 0;
+    checker->found += found;
+    checker->checked++;
+  }
+  return 0;
+}
+
+static void check_chunk_in_parallel (struct checker *checkers,
+                                     pthread_t *threads, unsigned size) {
+  for (unsigned i = 1; i < size; i++)
+    if (pthread_create (threads + i, 0, check_subsumption_candidates,
+                        checkers + i))
+      fatal_error ("failed to create subsumption thread %u", i);
+  check_subsumption_candidates (checkers);
+  for (unsigned i = 1; i < size; i++)
+    if (pthread_join (threads[i], 0))
+      fatal_error ("failed to join subsumption thread %u", i);
+}
+
+static bool stamped_clause (unsigned *stamps, unsigned stamp,
+                            struct clause *clause) {
+  for (all_literals_in_clause (lit, clause))
+    if (stamps[lit] == stamp || stamps[NOT (lit)] == stamp)
+      return true;
+  return false;
+}
+
+static void stamp_clause (unsigned *stamps, unsigned stamp,
+                          struct clause *clause) {
+  if (is_binary_pointer (clause)) {
+    stamps[lit_pointer (clause)] = stamp;
+    stamps[other_pointer (clause)] = stamp;
+  } else
+    for (all_literals_in_clause (lit, clause))
+      stamps[lit] = stamp;
+}
+
+static bool subsumes_or_strengthens (signed char *marks,
+                                     struct clause *clause) {
+  unsigned negative = 0;
+  if (is_binary_pointer (clause)) {
+    signed char mark = marked_literal (marks, lit_pointer (clause));
+    if (!mark)
+      return false;
+    negative += mark < 0;
+    mark = marked_literal (marks, other_pointer (clause));
+    if (!mark)
+      return false;
+    negative += mark < 0;
+  } else {
+    if (clause->garbage)
+      return false;
+    for (all_literals_in_clause (lit, clause)) {
+      signed char mark = marked_literal (marks, lit);
+      if (!mark)
+        return false;
+      if (mark < 0 && negative++)
+        return false;
+    }
+  }
+  return negative < 2;
+}
+
+// Checks whether a clause added while committing the current chunk might
+// subsume or strengthen the candidate.
+
+static bool recheck_candidate (struct simplifier *simplifier,
+                               struct chunk *chunk, struct clause *clause) {
+  if (!stamped_clause (chunk->stamps, chunk->stamp, clause))
+    return false;
+  signed char *marks = simplifier->marks;
+  mark_clause (marks, clause, INVALID);
+  bool res = false;
+  for (all_clauses (added, chunk->added))
+    if ((res = subsumes_or_strengthens (marks, added)))
+      break;
+  unmark_clause (marks, clause, INVALID);
+  return res;
+}
+
+static bool commit_chunk (struct simplifier *simplifier,
+                          struct chunk *chunk) {
+  struct ruler *ruler = simplifier->ruler;
+  unsigned *stamps = chunk->stamps;
+  unsigned stamp = ++chunk->stamp;
+  size_t size = chunk->end - chunk->begin;
+  CLEAR (chunk->added);
+  for (size_t i = 0; i != size; i++) {
+    if (ruler->terminate)
+      return false;
+    struct clause *clause = chunk->begin[i];
+    if (chunk->found[i])
+      clause = forward_subsume_large_clause (simplifier, clause);
+    else if (recheck_candidate (simplifier, chunk, clause)) {
+      clause = forward_subsume_large_clause (simplifier, clause);
+      chunk->rechecked++;
+    } else {
+      simplifier->ticks += chunk->ticks[i];
+      connect_least_occurring_literal (ruler, clause);
+    }
+    if (clause) {
+      stamp_clause (stamps, stamp, clause);
+      PUSH (chunk->added, clause);
+    }
+    flush_subsumption_ticks (simplifier);
+    if (subsumption_ticks_limit_hit (simplifier))
+      return false;
+  }
+  return true;
+}
+
+static void subsume_candidates_in_parallel (struct simplifier *simplifier,
+                                            struct clause **candidates,
+                                            size_t size_candidates,
+                                            unsigned threads,
+                                            unsigned round) {
+  struct ruler *ruler = simplifier->ruler;
+  struct chunk chunk;
+  memset (&chunk, 0, sizeof chunk);
+  chunk.found = allocate_array (SUBSUMPTION_CHUNK, sizeof *chunk.found);
+  chunk.ticks = allocate_array (SUBSUMPTION_CHUNK, sizeof *chunk.ticks);
+  chunk.stamps =
+      allocate_and_clear_array (2 * ruler->compact, sizeof *chunk.stamps);
+  struct checker *checkers =
+      allocate_and_clear_array (threads, sizeof *checkers);
+  pthread_t *handles = allocate_array (threads, sizeof *handles);
+  for (unsigned i = 0; i != threads; i++) {
+    struct checker *checker = checkers + i;
+    checker->chunk = &chunk;
+    if (i) {
+      checker->simplifier.ruler = ruler;
+      checker->simplifier.marks =
+          allocate_and_clear_block (2 * ruler->compact);
+    }
+  }
+  struct clause **end_candidates = candidates + size_candidates;
+  struct clause **p = candidates;
+  while (p != end_candidates) {
+    size_t remaining = end_candidates - p;
+    size_t size = MIN (remaining, SUBSUMPTION_CHUNK);
+    chunk.begin = p;
+    chunk.end = p += size;
+    atomic_store_explicit (&chunk.next, 0, memory_order_relaxed);
+    struct simplifier *first = &checkers[0].simplifier;
+    first->ruler = ruler;
+    first->marks = simplifier->marks;
+    unsigned active = MIN (threads, size);
+    check_chunk_in_parallel (checkers, handles, active);
+    if (!commit_chunk (simplifier, &chunk))
+      break;
+  }
+#ifndef QUIET
+  size_t checked = p - candidates;
+  verbose (0,
+           "[%u] checked %zu forward subsumption candidates %.0f%% "
+           "in chunks of %u with %u threads",
+           round, checked, percent (checked, size_candidates),
+           SUBSUMPTION_CHUNK, threads);
+  verbose (0, "[%u] rechecked %zu candidates %.0f%% sequentially", round,
+           chunk.rechecked, percent (chunk.rechecked, checked));
+  for (unsigned i = 0; i != threads; i++) {
+    struct checker *checker = checkers + i;
+    very_verbose (0,
+                  "[%u] subsumption thread %u checked %zu candidates "
+                  "found %zu %.0f%% in %" PRIu64 " ticks",
+                  round, i, checker->checked, checker->found,
+                  percent (checker->found, checker->checked),
+                  checker->ticks);
+  }
+#endif
+  struct ruler_statistics *statistics = &ruler->statistics;
+  for (unsigned i = 0; i != threads; i++) {
+    struct simplifier *checking = &checkers[i].simplifier;
+    statistics->signatures.checked += checking->signatures.checked;
+    statistics->signatures.filtered += checking->signatures.filtered;
+    if (i)
+      free (checking->marks);
+  }
+  free (handles);
+  free (checkers);
+  free (chunk.found);
+  free (chunk.ticks);
+  free (chunk.stamps);
+  RELEASE (chunk.added);
+}
+
+static unsigned subsumption_threads (struct ruler *ruler) {
+  struct options *options = &ruler->options;
+  return MIN (options->threads, options->subsume_threads);
+}
+
 bool subsume_clauses (struct simplifier *simplifier, unsigned round) {
   struct ruler *ruler = simplifier->ruler;
   if (!ruler->options.subsume)
@@ -344,21 +644,28 @@ bool subsume_clauses (struct simplifier *simplifier, unsigned round) {
   struct ruler_statistics *statistics = &ruler->statistics;
   subsumed.before = statistics->subsumed;
   strengthened.before = statistics->strengthened;
-  struct clause **end_candidates = candidates + size_candidates;
-  for (struct clause **p = candidates; p != end_candidates; p++) {
-    if (ruler->terminate)
-      break;
-    forward_subsume_large_clause (simplifier, *p);
-    if (subsumption_ticks_limit_hit (simplifier)) {
+  unsigned threads = subsumption_threads (ruler);
+  if (threads > 1)
+    subsume_candidates_in_parallel (simplifier, candidates,
+                                    size_candidates, threads, round);
+  else {
+    struct clause **end_candidates = candidates + size_candidates;
+    for (struct clause **p = candidates; p != end_candidates; p++) {
+      if (ruler->terminate)
+        break;
+      (void) forward_subsume_large_clause (simplifier, *p);
+      flush_subsumption_ticks (simplifier);
+      if (subsumption_ticks_limit_hit (simplifier)) {
 #ifndef QUIET
-      size_t scheduled = end_candidates - candidates;
-      size_t checked = p + 1 - candidates;
-      very_verbose (0,
-                    "subsumption ticks limit hit "
-                    "after checking %zu candidates %.0f%%",
-                    checked, percent (checked, scheduled));
+        size_t scheduled = end_candidates - candidates;
+        size_t checked = p + 1 - candidates;
+        very_verbose (0,
+                      "subsumption ticks limit hit "
+                      "after checking %zu candidates %.0f%%",
+                      checked, percent (checked, scheduled));
 #endif
-      break;
+        break;
+      }
     }
   }
   free (candidates);
@@ -0,0 +1,62 @@
+#include "telemetry.h"
+#include "message.h"
+#include "ruler.h"
+#include "utilities.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+void dump_telemetry (struct ruler *ruler) {
+  const char *path = ruler->options.telemetry;
+  assert (path);
+  struct rings *rings = &ruler->rings;
+  unsigned threads = SIZE (*rings);
+  if (threads < 2)
+    return;
+  FILE *file = fopen (path, "w");
+  if (!file) {
+    message (0, "failed to write telemetry file '%s'", path);
+    return;
+  }
+  fputs ("sender,receiver,offered,pooled,overwritten,dropped,throttled,"
+         "imported,subsumed,used,samples,"
+         "latency_conflicts,latency_seconds\n",
+         file);
+  for (all_rings (sender)) {
+    if (!sender->pool)
+      continue;
+    for (all_rings (receiver)) {
+      if (receiver == sender)
+        continue;
+      struct pool *pool = sender->pool + receiver->id;
+      struct source *source = receiver->sources + sender->id;
+      uint64_t imported = pool->imported;
+      uint64_t samples = source->latency.samples;
+      fprintf (file,
+               "%u,%u,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+               ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+               ",%.2f,%.6f\n",
+               sender->id, receiver->id, pool->offered,
+               pool->exported, pool->overwritten, pool->dropped,
+               pool->throttled, imported, source->subsumed, source->used,
+               samples, average (source->latency.conflicts, samples),
+               average (1e-6 * source->latency.microseconds, samples));
+    }
+  }
+  fclose (file);
+  verbose (0, "wrote telemetry of %u rings to '%s'", threads, path);
+}
+
+void request_telemetry (struct ruler *ruler) {
+  atomic_store_explicit (&ruler->telemetry, true, memory_order_relaxed);
+}
+
+void check_telemetry_request (struct ring *ring) {
+  struct ruler *ruler = ring->ruler;
+  if (!atomic_load_explicit (&ruler->telemetry, memory_order_relaxed))
+    return;
+  if (!atomic_exchange (&ruler->telemetry, false))
+    return;
+  message (ring, "dumping telemetry on request");
+  dump_telemetry (ruler);
+}
@@ -0,0 +1,57 @@
+#ifndef _telemetry_h_INCLUDED
+#define _telemetry_h_INCLUDED
+
+#include "ring.h"
+#include "system.h"
+
+// With '--telemetry=<file>' clause sharing is instrumented per pair of
+// sending and receiving ring.  Most counters are maintained anyway (in
+// the pools of the sender and the sources of the receiver).  Telemetry
+// only adds time stamps to the pool buckets of exported clauses (in a
+// separate array allocated only if enabled), from which the import
+// latency is sampled in wall clock time and in conflicts of the receiver.
+// The latter are published by the receiver whenever it tries to import.
+// The CSV file is written at exit and whenever 'SIGUSR1' is caught.  If
+// telemetry is disabled the only cost is checking the option.
+
+struct ruler;
+
+void dump_telemetry (struct ruler *);
+void request_telemetry (struct ruler *);
+void check_telemetry_request (struct ring *);
+
+static inline void publish_telemetry_conflicts (struct ring *ring) {
+  atomic_store_explicit (&ring->telemetry_conflicts, SEARCH_CONFLICTS,
+                         memory_order_relaxed);
+}
+
+static inline void stamp_exported_clause (struct ring *other,
+                                          struct pool *pool,
+                                          struct bucket *bucket) {
+  struct stamp *stamp = pool->stamps + (bucket - pool->bucket);
+  uint64_t conflicts = atomic_load_explicit (&other->telemetry_conflicts,
+                                             memory_order_relaxed);
+  uint64_t time = 1e6 * current_time ();
+  atomic_store_explicit (&stamp->conflicts, conflicts,
+                         memory_order_relaxed);
+  atomic_store_explicit (&stamp->time, time, memory_order_relaxed);
+}
+
+static inline void sample_import_latency (struct ring *ring,
+                                          struct source *source,
+                                          struct pool *pool,
+                                          struct bucket *bucket) {
+  struct stamp *stamp = pool->stamps + (bucket - pool->bucket);
+  uint64_t conflicts =
+      atomic_load_explicit (&stamp->conflicts, memory_order_relaxed);
+  uint64_t time =
+      atomic_load_explicit (&stamp->time, memory_order_relaxed);
+  uint64_t now = 1e6 * current_time ();
+  source->latency.samples++;
+  if (conflicts <= SEARCH_CONFLICTS)
+    source->latency.conflicts += SEARCH_CONFLICTS - conflicts;
+  if (time <= now)
+    source->latency.microseconds += now - time;
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "topology.h"
+#include "allocate.h"
+#include "message.h"
+#include "ruler.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_CPUS 4096
+#define MAX_NODES 256
+
+// Parses a CPU list as '0-3,8-11' and sets the domain of all listed and
+// not yet assigned CPUs.  Returns the number of CPUs assigned.
+
+static unsigned read_cpu_list (const char *path, unsigned *domain_of,
+                               unsigned domain) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    return 0;
+  unsigned res = 0, first, last;
+  int ch = ',';
+  while (ch == ',' && fscanf (file, "%u", &first) == 1) {
+    last = first;
+    ch = getc (file);
+    if (ch == '-') {
+      if (fscanf (file, "%u", &last) != 1)
+        break;
+      ch = getc (file);
+    }
+    for (unsigned cpu = first; cpu <= last && cpu < MAX_CPUS; cpu++)
+      if (domain_of[cpu] == INVALID) {
+        domain_of[cpu] = domain;
+        res++;
+      }
+  }
+  fclose (file);
+  return res;
+}
+
+static unsigned read_numa_domains (unsigned *domain_of) {
+  char path[64];
+  unsigned domains = 0;
+  for (unsigned node = 0; node != MAX_NODES; node++) {
+    sprintf (path, "/sys/devices/system/node/node%u/cpulist", node);
+    if (read_cpu_list (path, domain_of, domains))
+      domains++;
+  }
+  return domains;
+}
+
+static unsigned read_cache_domains (unsigned *domain_of,
+                                    const unsigned *online) {
+  char path[80];
+  unsigned domains = 0;
+  for (unsigned cpu = 0; cpu != MAX_CPUS; cpu++) {
+    if (online[cpu] == INVALID || domain_of[cpu] != INVALID)
+      continue;
+    sprintf (path,
+             "/sys/devices/system/cpu/cpu%u/cache/index3/shared_cpu_list",
+             cpu);
+    if (read_cpu_list (path, domain_of, domains))
+      domains++;
+  }
+  return domains;
+}
+
+void init_topology (struct ruler *ruler) {
+  struct topology *topology = &ruler->topology;
+  assert (!topology->cpus);
+  unsigned *online = allocate_array (MAX_CPUS, sizeof *online);
+  unsigned *domain_of = allocate_array (MAX_CPUS, sizeof *domain_of);
+  for (unsigned cpu = 0; cpu != MAX_CPUS; cpu++)
+    online[cpu] = domain_of[cpu] = INVALID;
+  unsigned size =
+      read_cpu_list ("/sys/devices/system/cpu/online", online, 0);
+  unsigned count = 0;
+  const char *source = "no topology";
+  if (size) {
+    count = read_numa_domains (domain_of);
+    source = "NUMA nodes";
+    if (count < 2) {
+      for (unsigned cpu = 0; cpu != MAX_CPUS; cpu++)
+        domain_of[cpu] = INVALID;
+      count = read_cache_domains (domain_of, online);
+      source = "shared L3 caches";
+    }
+    for (unsigned cpu = 0; cpu != MAX_CPUS; cpu++)
+      if (online[cpu] != INVALID && domain_of[cpu] == INVALID)
+        domain_of[cpu] = count;
+    for (unsigned cpu = 0; cpu != MAX_CPUS; cpu++)
+      if (domain_of[cpu] == count) {
+        count++;
+        break;
+      }
+  }
+  if (size) {
+    topology->cpus = allocate_array (size, sizeof *topology->cpus);
+    topology->domains = allocate_array (size, sizeof *topology->domains);
+    unsigned i = 0;
+    for (unsigned domain = 0; domain != count; domain++)
+      for (unsigned cpu = 0; cpu != MAX_CPUS; cpu++)
+        if (online[cpu] != INVALID && domain_of[cpu] == domain) {
+          topology->cpus[i] = cpu;
+          topology->domains[i] = domain;
+          i++;
+        }
+    assert (i == size);
+  }
+  topology->size = size;
+  topology->count = count;
+  free (domain_of);
+  free (online);
+  unsigned threads = SIZE (ruler->rings);
+  for (all_rings (ring)) {
+    if (size) {
+      unsigned i = ring->id;
+      if (threads <= size)
+        i = (unsigned) ((uint64_t) i * size / threads);
+      else
+        i %= size;
+      ring->cpu = topology->cpus[i];
+      ring->domain = topology->domains[i];
+    } else {
+      ring->cpu = INVALID;
+      ring->domain = 0;
+    }
+    very_verbose (ring, "assigned to CPU %u in domain %u", ring->cpu,
+                  ring->domain);
+  }
+  verbose (0, "found %u online CPUs in %u domains (%s)", size, count,
+           source);
+  (void) source;
+}
+
+void release_topology (struct ruler *ruler) {
+  struct topology *topology = &ruler->topology;
+  free (topology->cpus);
+  free (topology->domains);
+}
+
+void pin_ring (struct ring *ring) {
+  if (ring->cpu == INVALID)
+    return;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO (&set);
+  CPU_SET (ring->cpu, &set);
+  if (pthread_setaffinity_np (pthread_self (), sizeof set, &set))
+    message (ring, "failed to pin ring %u to CPU %u", ring->id, ring->cpu);
+  else
+    verbose (ring, "pinned ring %u to CPU %u", ring->id, ring->cpu);
+#endif
+}
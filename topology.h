@@ -0,0 +1,27 @@
+#ifndef _topology_h_INCLUDED
+#define _topology_h_INCLUDED
+
+// The CPU topology is read from '/sys/devices/system/node' (NUMA nodes)
+// and, if there is only one node, from the level three cache sharing
+// information in '/sys/devices/system/cpu'.  Each CPU is put into one
+// domain and the online CPUs are ordered by domain.  Rings are assigned to
+// CPUs in this order, spread evenly if there are fewer rings than CPUs,
+// which yields the domain of each ring.  This assignment is only enforced
+// if threads are pinned.  If the topology can not be read all rings are
+// put into one domain.
+
+struct ring;
+struct ruler;
+
+struct topology {
+  unsigned *cpus;
+  unsigned *domains;
+  unsigned size;
+  unsigned count;
+};
+
+void init_topology (struct ruler *);
+void release_topology (struct ruler *);
+void pin_ring (struct ring *);
+
+#endif
@@ -52,10 +52,11 @@ void check_types (void) {
   }
 
   {
-    size_t glue_in_watcher_bytes = sizeof ((struct watcher *) 0)->glue;
-    if (1 << (glue_in_watcher_bytes * 8) <= MAX_GLUE)
-      fatal_error ("'MAX_GLUE = %u' exceeds 'sizeof (watcher.glue) = %zu'",
-                   MAX_GLUE, glue_in_watcher_bytes);
+    size_t glue_in_usage_bytes =
+        sizeof ((struct watcher_usage *) 0)->glue;
+    if (1 << (glue_in_usage_bytes * 8) <= MAX_GLUE)
+      fatal_error ("'MAX_GLUE = %u' exceeds 'sizeof (usage.glue) = %zu'",
+                   MAX_GLUE, glue_in_usage_bytes);
   }
 
   if (verbosity > 0) {
@@ -63,6 +64,8 @@ void check_types (void) {
     printf ("c sizeof (struct clause) = %zu\n", sizeof (struct clause));
     printf ("c sizeof (struct counter) = %zu\n", sizeof (struct counter));
     printf ("c sizeof (struct phases) = %zu\n", sizeof (struct phases));
+    printf ("c sizeof (struct watcher_usage) = %zu\n",
+            sizeof (struct watcher_usage));
     printf ("c sizeof (struct variable) = %zu\n", sizeof (struct variable));
     printf ("c sizeof (struct watcher) = %zu\n", sizeof (struct watcher));
   }
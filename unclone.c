@@ -17,20 +17,18 @@ static void save_ring_binaries (struct ring *ring) {
 
   for (all_ring_literals (lit)) {
     struct references *references = &REFERENCES (lit);
-    for (all_watches (watch, *references)) {
-      if (!is_binary_pointer (watch))
-        continue;
-      assert (redundant_pointer (watch));
-      unsigned other = other_pointer (watch);
+    for (all_elements_on_stack (unsigned, other, references->redundant)) {
       if (other >= lit)
         continue;
       struct saved_watcher sw;
       sw.used = 0;
       sw.vivify = 0;
-      sw.clause = (struct clause *) watch;
+      sw.source = 0;
+      sw.clause = tag_binary (true, lit, other);
       PUSH (*saved, sw);
     }
-    RELEASE (*references);
+    release_vector (ring, references);
+    RELEASE (references->redundant);
     if (ring->id)
       continue;
     unsigned *binaries = references->binaries;
@@ -84,7 +82,9 @@ static void save_large_watched_clauses (struct ring *ring) {
 #endif
     } else {
       if (watcher->redundant) {
-        struct saved_watcher sw = saved_watcher_from_watcher (watcher);
+        struct watcher_usage *usage = watcher_to_usage (ring, watcher);
+        struct saved_watcher sw =
+            saved_watcher_from_watcher (watcher, usage);
         PUSH (*save, sw);
 #ifndef QUIET
         saved++;
@@ -104,6 +104,7 @@ static void save_large_watched_clauses (struct ring *ring) {
     }
   }
   RESIZE (ring->watchers, 1);
+  RESIZE (ring->usages, 1);
   very_verbose (ring, "saved %zu redundant large watches", saved);
   very_verbose (ring, "collected %zu large watches", collected);
   if (ring->id) {
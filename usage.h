@@ -25,6 +25,9 @@ static char * compact_usage =
 "  -V  |  --version              print version\n"
 "\n"
 "  --conflicts=0...              limit conflicts (unlimited by default)\n"
+"  --connect=<host>:<port>,...  connect to peers in distributed mode\n"
+"  --exchange=<name>             share clauses between processes\n"
+"  --telemetry=<file>            write clause sharing telemetry as CSV\n"
 "  --threads=1..65536            set number of threads (default '1')\n"
 "  --time=1...                   limit time in seconds (unlimited by default)\n"
 "\n"
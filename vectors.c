@@ -0,0 +1,112 @@
+#include "vectors.h"
+#include "message.h"
+#include "ring.h"
+#include "utilities.h"
+
+#include <string.h>
+
+// Defragmenting leaves some slack after each non-empty watch list, as
+// otherwise the first watch added to any list would move it again.
+
+#define VECTOR_SLACK(SIZE) (1 + (SIZE) / 4)
+
+void defrag_vectors (struct ring *ring, size_t reserve) {
+  struct vectors *vectors = &ring->vectors;
+  size_t needed = reserve;
+  for (all_ring_literals (lit)) {
+    size_t size = SIZE (REFERENCES (lit));
+    if (size)
+      needed += size + VECTOR_SLACK (size);
+  }
+  size_t used = SIZE (*vectors) - vectors->wasted + reserve;
+  if (used < needed)
+    used = needed;
+  size_t capacity = CAPACITY (*vectors);
+  if (used > capacity / 2)
+    capacity = 2 * used;
+  struct watch **begin = 0;
+  if (capacity)
+    begin = allocate_array (capacity, sizeof *begin);
+  struct watch **end = begin;
+  for (all_ring_literals (lit)) {
+    struct references *references = &REFERENCES (lit);
+    size_t size = SIZE (*references);
+    if (size) {
+      memcpy (end, references->begin, size * sizeof *end);
+      references->begin = end;
+      references->end = end + size;
+      end += size + VECTOR_SLACK (size);
+      references->allocated = end;
+    } else
+      references->begin = references->end = references->allocated = 0;
+  }
+  assert ((size_t) (end - begin) + reserve == needed);
+  very_verbose (ring,
+                "defragmented watch arena of %zu bytes "
+                "wasting %zu bytes %.0f%%",
+                CAPACITY (*vectors) * sizeof *begin,
+                vectors->wasted * sizeof *begin,
+                percent (vectors->wasted, CAPACITY (*vectors)));
+  free (vectors->begin);
+  vectors->begin = begin;
+  vectors->end = end;
+  vectors->allocated = begin + capacity;
+  vectors->wasted = 0;
+  vectors->statistics.defragmentations++;
+}
+
+void enlarge_vector (struct ring *ring, struct references *references) {
+  struct vectors *vectors = &ring->vectors;
+  size_t size = SIZE (*references);
+  size_t capacity = CAPACITY (*references);
+  assert (size == capacity);
+  size_t available = vectors->allocated - vectors->end;
+  if (capacity && references->allocated == vectors->end &&
+      capacity <= available) {
+    vectors->end += capacity;
+    references->allocated += capacity;
+    vectors->statistics.enlarged++;
+    return;
+  }
+  size_t new_capacity = capacity ? 2 * capacity : 1;
+  if (new_capacity > available) {
+    defrag_vectors (ring, new_capacity);
+    if (size)
+      return;
+  }
+  struct watch **begin = vectors->end;
+  if (size)
+    memcpy (begin, references->begin, size * sizeof *begin);
+  vectors->wasted += capacity;
+  vectors->end += new_capacity;
+  assert (vectors->end <= vectors->allocated);
+  references->begin = begin;
+  references->end = begin + size;
+  references->allocated = begin + new_capacity;
+  vectors->statistics.moved++;
+}
+
+void release_vector (struct ring *ring, struct references *references) {
+  struct vectors *vectors = &ring->vectors;
+  if (references->allocated && references->allocated == vectors->end)
+    vectors->end = references->begin;
+  else
+    vectors->wasted += CAPACITY (*references);
+  references->begin = references->end = references->allocated = 0;
+}
+
+void clear_vectors (struct ring *ring) {
+  struct vectors *vectors = &ring->vectors;
+#ifndef NDEBUG
+  for (all_ring_literals (lit))
+    assert (!REFERENCES (lit).begin);
+#endif
+  vectors->end = vectors->begin;
+  vectors->wasted = 0;
+}
+
+void release_vectors (struct ring *ring) {
+  struct vectors *vectors = &ring->vectors;
+  RELEASE (*vectors);
+  vectors->wasted = 0;
+}
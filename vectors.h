@@ -0,0 +1,40 @@
+#ifndef _vectors_h_INCLUDED
+#define _vectors_h_INCLUDED
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// All watch lists of a ring are allocated consecutively in one large array
+// (the 'vectors' arena) instead of as individual heap blocks.  A watch list
+// which becomes full is moved to the end of the arena with twice its
+// capacity, except if it already is the last one, in which case it grows in
+// place.  The space of moved or released watch lists is wasted until the
+// arena is defragmented, which happens if it has to be enlarged and during
+// reductions.  Defragmenting packs the lists but leaves some slack after
+// each of them and reserves the requested space at the end of the arena,
+// which is doubled if it would otherwise be more than half full.  Moving
+// lists or defragmenting the arena invalidates pointers into watch lists
+// except for the 'begin', 'end' and 'allocated' fields of references,
+// which are updated.
+
+struct ring;
+struct references;
+struct watch;
+
+struct vectors {
+  struct watch **begin, **end, **allocated;
+  size_t wasted;
+  struct {
+    uint64_t defragmentations;
+    uint64_t enlarged;
+    uint64_t moved;
+  } statistics;
+};
+
+void enlarge_vector (struct ring *, struct references *);
+void release_vector (struct ring *, struct references *);
+void defrag_vectors (struct ring *, size_t reserve);
+void clear_vectors (struct ring *);
+void release_vectors (struct ring *);
+
+#endif
@@ -52,7 +52,8 @@ static inline bool watched_vivification_candidate (struct ring *ring,
     return false;
   if (!watcher->redundant)
     return false;
-  unsigned watcher_glue = watcher_glue;
+  struct watcher_usage *usage = watcher_to_usage (ring, watcher);
+  unsigned watcher_glue = usage->glue;
   unsigned tier1 = ring->tier1_glue_limit[0]; // NO TYPO!
   unsigned tier2 = ring->tier2_glue_limit[0]; // NO TYPO!
   if (tier == 1) {
@@ -60,20 +61,20 @@ static inline bool watched_vivification_candidate (struct ring *ring,
       struct clause *clause = watcher->clause;
       unsigned clause_glue = clause->glue;
       if (clause_glue < watcher_glue) {
-        watcher->glue = clause_glue;
+        usage->glue = clause_glue;
         if (clause_glue > tier1)
           return false;
       }
       return false;
     }
   } else if (tier == 2) {
-    if (watcher->glue <= tier1)
+    if (watcher_glue <= tier1)
       return false;
-    if (watcher->glue > tier2) {
+    if (watcher_glue > tier2) {
       struct clause *clause = watcher->clause;
       unsigned clause_glue = clause->glue;
       if (clause_glue < watcher_glue) {
-        watcher->glue = clause_glue;
+        usage->glue = clause_glue;
         if (clause_glue > tier2)
           return false;
       }
@@ -233,7 +234,7 @@ static void sort_vivivification_candidates (struct ring *ring,
         unsigned size = watcher->size;
         LOGPREFIX ("sorted glue %u size %u watcher[%u] "
                    "vivification candidate",
-                   watcher->glue, size, idx);
+                   index_to_usage (ring, idx)->glue, size, idx);
         unsigned *lits = watcher->aux;
         unsigned *end_lits = lits + size;
         for (unsigned *p = lits; p != end_lits; p++) {
@@ -249,7 +250,7 @@ static void sort_vivivification_candidates (struct ring *ring,
         struct clause *clause = watcher->clause;
         LOGPREFIX ("sorted glue %u size %u watcher[%u] "
                    "vivification candidate",
-                   watcher->glue, clause->size, idx);
+                   index_to_usage (ring, idx)->glue, clause->size, idx);
         unsigned *lits = watcher->aux;
         unsigned *end_lits = lits + SIZE_WATCHER_LITERALS;
         for (unsigned *p = lits; p != end_lits; p++) {
@@ -272,7 +273,7 @@ static size_t reschedule_vivification_candidates (struct vivifier *vivifier,
   struct ring *ring = vivifier->ring;
   assert (EMPTY (*candidates));
   for (all_redundant_watchers (watcher))
-    if (watcher->vivify &&
+    if (watcher_to_usage (ring, watcher)->vivify &&
         watched_vivification_candidate (ring, watcher, tier))
       schedule_vivification_candidate (ring, counts, candidates, watcher);
   size_t size = SIZE (*candidates);
@@ -288,7 +289,7 @@ static size_t schedule_vivification_candidates (struct vivifier *vivifier,
   memset (counts, 0, sizeof (unsigned) * 2 * ring->size);
   size_t before = SIZE (*candidates);
   for (all_redundant_watchers (watcher))
-    if (!watcher->vivify &&
+    if (!watcher_to_usage (ring, watcher)->vivify &&
         watched_vivification_candidate (ring, watcher, tier))
       schedule_vivification_candidate (ring, counts, candidates, watcher);
   size_t after = SIZE (*candidates);
@@ -457,7 +458,7 @@ static void vivify_learn (struct vivifier *vivifier,
     trace_add_unit (&ring->trace, unit);
     ring->statistics.vivify.units++;
     assign_ring_unit (ring, unit);
-    if (ring_propagate (ring, false, 0))
+    if (probing_propagate (ring))
       set_inconsistent (ring,
                         "propagation of strengthened clause unit fails");
     else {
@@ -466,21 +467,27 @@ static void vivify_learn (struct vivifier *vivifier,
     }
   } else if (size == 2) {
     unsigned lit = literals[0], other = literals[1];
-    res = new_local_binary_clause (ring, true, lit, other);
-    trace_add_binary (&ring->trace, lit, other);
-    if (ring->options.vivify_export)
+    if (ring->options.vivify_export) {
+      res = new_learned_binary_clause (ring, lit, other);
+      trace_add_binary (&ring->trace, lit, other);
       export_binary_clause (ring, res);
+    } else {
+      res = new_local_binary_clause (ring, true, lit, other);
+      trace_add_binary (&ring->trace, lit, other);
+    }
   } else {
     struct watcher *watcher = get_watcher (ring, candidate);
     unsigned glue = SIZE (*levels);
     LOG ("computed glue %u", glue);
-    if (glue > watcher->glue) {
-      glue = watcher->glue;
+    unsigned watcher_glue = watcher_to_usage (ring, watcher)->glue;
+    if (glue > watcher_glue) {
+      glue = watcher_glue;
       LOG ("but candidate glue %u smaller", glue);
     }
     if (glue == size)
       glue = size - 1;
-    struct clause *clause = new_large_clause (size, literals, true, glue);
+    struct clause *clause =
+        new_large_clause (ring->arena, size, literals, true, glue);
     LOGCLAUSE (clause, "vivify strengthened");
     clause->origin = ring->id;
     res = watch_first_two_literals_in_large_clause (ring, clause);
@@ -514,7 +521,7 @@ static void vivify_watcher (struct vivifier *vivifier, unsigned tier,
     mark_garbage_watcher (ring, watcher);
     return;
   }
-  watcher->vivify = false;
+  index_to_usage (ring, idx)->vivify = false;
 
   signed char *values = ring->values;
   struct clause *clause = watcher->clause;
@@ -642,7 +649,7 @@ static void vivify_watcher (struct vivifier *vivifier, unsigned tier,
     assign_decision (ring, not_lit);
     PUSH (*decisions, not_lit);
 
-    conflict = ring_propagate (ring, false, clause);
+    conflict = vivify_propagate (ring, clause);
     if (conflict)
       break;
   }
@@ -672,8 +679,9 @@ static void vivify_watcher (struct vivifier *vivifier, unsigned tier,
         assert (clause != subsuming_watcher->clause);
         assert (clause->redundant);
         assert (watcher->redundant);
-        unsigned watcher_glue = watcher->glue;
-        unsigned subsuming_glue = subsuming_watcher->glue;
+        unsigned watcher_glue = index_to_usage (ring, idx)->glue;
+        unsigned subsuming_glue =
+            watcher_to_usage (ring, subsuming_watcher)->glue;
         if (watcher_glue < subsuming_glue)
           promote_watcher (ring, subsuming_watcher, watcher_glue);
       }
@@ -806,7 +814,7 @@ void vivify_clauses (struct ring *ring) {
         }
         RESIZE (*decisions, ring->level);
         assert (ring->level == SIZE (*decisions));
-        if (ring_propagate (ring, false, 0)) {
+        if (probing_propagate (ring)) {
           set_inconsistent (ring, "propagation of imported clauses "
                                   "during vivification fails");
           break;
@@ -836,8 +844,7 @@ void vivify_clauses (struct ring *ring) {
 
     while (i != final_scheduled) {
       unsigned idx = vivifier.candidates.begin[i++];
-      struct watcher *watcher = index_to_watcher (ring, idx);
-      watcher->vivify = true;
+      index_to_usage (ring, idx)->vivify = true;
     }
 
     release_vivifier (&vivifier);
@@ -25,6 +25,7 @@ struct doubles {
 struct counters {
   struct counter **begin, **end, **allocated;
   unsigned *binaries;
+  struct unsigneds redundant;
 };
 
 struct walker {
@@ -342,7 +343,8 @@ static void delete_walker (struct walker *walker) {
   RELEASE (walker->trail);
   RELEASE (walker->scores);
   RELEASE (walker->breaks);
-  release_references (ring);
+  for (all_ring_literals (lit))
+    RELEASE (COUNTERS (lit));
   reconnect_watches (ring, &walker->saved);
   RELEASE (walker->saved);
   free (walker);
@@ -660,6 +662,7 @@ void local_search (struct ring *ring) {
   assert (ring->context == SEARCH_CONTEXT);
   ring->context = WALK_CONTEXT;
   ring->statistics.walked++;
+  clear_saved_trail (ring);
   if (ring->last.fixed != ring->statistics.fixed)
     mark_satisfied_watchers_as_garbage (ring);
   {
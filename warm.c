@@ -21,7 +21,7 @@ void warming_up_saved_phases (struct ring *ring) {
     decisions++;
 #endif
     decide (ring);
-    if (ring_propagate (ring, false, 0)) {
+    if (probing_propagate (ring)) {
 #ifndef QUIET
       conflicts++;
 #endif
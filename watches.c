@@ -2,6 +2,7 @@
 #include "clause.h"
 #include "message.h"
 #include "ring.h"
+#include "ruler.h"
 #include "tagging.h"
 #include "trace.h"
 #include "utilities.h"
@@ -11,8 +12,12 @@
 
 void release_references (struct ring *ring) {
   if (ring->references)
-    for (all_ring_literals (lit))
-      RELEASE (REFERENCES (lit));
+    for (all_ring_literals (lit)) {
+      struct references *references = &REFERENCES (lit);
+      release_vector (ring, references);
+      RELEASE (references->redundant);
+    }
+  release_vectors (ring);
 }
 
 void disconnect_references (struct ring *ring, struct watches *saved) {
@@ -21,19 +26,16 @@ void disconnect_references (struct ring *ring, struct watches *saved) {
 #endif
   for (all_ring_literals (lit)) {
     struct references *watches = &REFERENCES (lit);
-    for (all_watches (watch, *watches))
-      if (is_binary_pointer (watch)) {
-        assert (redundant_pointer (watch));
-        assert (lit_pointer (watch) == lit);
-        unsigned other = other_pointer (watch);
-        if (other < lit)
-          PUSH (*saved, watch);
-      }
+    for (all_elements_on_stack (unsigned, other, watches->redundant))
+      if (other < lit)
+        PUSH (*saved, tag_binary (true, lit, other));
 #ifndef QUIET
-    disconnected += SIZE (*watches);
+    disconnected += SIZE (*watches) + SIZE (watches->redundant);
 #endif
-    RELEASE (*watches);
+    release_vector (ring, watches);
+    RELEASE (watches->redundant);
   }
+  clear_vectors (ring);
   very_verbose (ring, "disconnected %zu clauses", disconnected);
 }
 
@@ -55,9 +57,8 @@ void reconnect_watches (struct ring *ring, struct watches *saved) {
     assert (redundant_pointer (lit_watch));
     unsigned lit = lit_pointer (lit_watch);
     unsigned other = other_pointer (lit_watch);
-    struct watch *other_watch = tag_binary (true, other, lit);
-    push_watch (ring, lit, lit_watch);
-    push_watch (ring, other, other_watch);
+    push_redundant_binary (ring, lit, other);
+    push_redundant_binary (ring, other, lit);
   }
   very_verbose (ring, "reconnected %zu clauses", reconnected);
   ring->trail.propagate = ring->trail.begin;
@@ -92,6 +93,11 @@ struct watch *watch_literals_in_large_clause (struct ring *ring,
   struct watcher *watcher = ring->watchers.end++;
   assert (ring->watchers.end <= ring->watchers.allocated);
 
+  if (FULL (ring->usages))
+    ENLARGE (ring->usages);
+  struct watcher_usage *usage = ring->usages.end++;
+  assert (SIZE (ring->usages) == SIZE (ring->watchers));
+
   unsigned size = clause->size;
   unsigned glue = clause->glue;
 
@@ -111,17 +117,18 @@ struct watch *watch_literals_in_large_clause (struct ring *ring,
   unsigned used = MAX_USED;
 
   assert (size < (1 << (8 * sizeof watcher->size)));
-  assert (glue < (1 << (8 * sizeof watcher->glue)));
-  assert (used < (1 << (8 * sizeof watcher->used)));
+  assert (glue < (1 << (8 * sizeof usage->glue)));
+  assert (used < (1 << (8 * sizeof usage->used)));
 
   watcher->size = size;
-  watcher->glue = glue;
-  watcher->used = used;
-
   watcher->garbage = false;
   watcher->reason = false;
   watcher->redundant = redundant;
-  watcher->vivify = false;
+
+  usage->glue = glue;
+  usage->used = used;
+  usage->vivify = false;
+  usage->source = ring->id;
 
   watcher->sum = first ^ second;
   watcher->clause = clause;
@@ -150,13 +157,20 @@ watch_first_two_literals_in_large_clause (struct ring *ring,
 
 struct watch *new_local_binary_clause (struct ring *ring, bool redundant,
                                        unsigned lit, unsigned other) {
+  assert (redundant);
   inc_clauses (ring, redundant);
-  struct watch *watch_lit = tag_binary (redundant, lit, other);
-  struct watch *watch_other = tag_binary (redundant, other, lit);
-  push_watch (ring, lit, watch_lit);
-  push_watch (ring, other, watch_other);
+  push_redundant_binary (ring, lit, other);
+  push_redundant_binary (ring, other, lit);
   LOGBINARY (redundant, lit, other, "new");
-  return watch_lit;
+  return tag_binary (redundant, lit, other);
+}
+
+struct watch *new_learned_binary_clause (struct ring *ring, unsigned lit,
+                                         unsigned other) {
+  if (!ring->ruler->store.chunks)
+    return new_local_binary_clause (ring, true, lit, other);
+  (void) add_stored_binary (ring, lit, other);
+  return tag_binary (true, lit, other);
 }
 
 unsigned *flush_watchers (struct ring *ring, unsigned start) {
@@ -169,6 +183,10 @@ unsigned *flush_watchers (struct ring *ring, unsigned start) {
   struct watcher *end = watchers->end;
   struct watcher *q = begin;
 
+  struct watcher_usages *usages = &ring->usages;
+  assert (SIZE (*usages) == SIZE (*watchers));
+  struct watcher_usage *u = usages->begin + start, *v = u;
+
   size_t size = end - begin;
   unsigned *map = allocate_and_clear_array (size, sizeof *map);
 
@@ -186,7 +204,7 @@ unsigned *flush_watchers (struct ring *ring, unsigned start) {
     redundant = ring->redundant;
   }
 
-  for (struct watcher *p = begin; p != end; p++, src++) {
+  for (struct watcher *p = begin; p != end; p++, u++, src++) {
     if (p->garbage && !p->reason) {
       struct clause *clause = p->clause;
 #ifndef QUIET
@@ -197,6 +215,7 @@ unsigned *flush_watchers (struct ring *ring, unsigned start) {
 #endif
     } else {
       *q++ = *p;
+      *v++ = *u;
 
       if (!redundant && p->redundant)
         redundant = dst;
@@ -210,6 +229,7 @@ unsigned *flush_watchers (struct ring *ring, unsigned start) {
     }
   }
   watchers->end = q;
+  usages->end = v;
 
   verbose (ring, "mapped %u non-garbage watchers %.0f%%", mapped,
            percent (mapped, size));
@@ -276,10 +296,10 @@ static void sort_by_glue (struct ring *ring, size_t size_indices,
   unsigned *end = indices + size_indices;
   for (unsigned *p = indices; p != end; p++) {
     unsigned idx = *p;
-    struct watcher *watcher = index_to_watcher (ring, idx);
-    assert (watcher->glue <= MAX_GLUE);
-    assert (watcher->redundant);
-    count[watcher->glue]++;
+    struct watcher_usage *usage = index_to_usage (ring, idx);
+    assert (usage->glue <= MAX_GLUE);
+    assert (index_to_watcher (ring, idx)->redundant);
+    count[usage->glue]++;
   }
   {
     size_t pos = 0, *c = count + size_count, size;
@@ -289,8 +309,8 @@ static void sort_by_glue (struct ring *ring, size_t size_indices,
   unsigned *tmp = sorter_block (ring, size_indices);
   for (unsigned *p = indices; p != end; p++) {
     unsigned idx = *p;
-    struct watcher *watcher = index_to_watcher (ring, idx);
-    tmp[count[watcher->glue]++] = idx;
+    struct watcher_usage *usage = index_to_usage (ring, idx);
+    tmp[count[usage->glue]++] = idx;
   }
   size_t bytes = size_indices * sizeof *indices;
   memcpy (indices, tmp, bytes);
@@ -4,23 +4,38 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include "stack.h"
 #include "tagging.h"
 
 struct clause;
 struct ring;
-struct unsigneds;
 
+// Literals of clauses with at most this many literals are copied into
+// their watchers, which avoids accessing the actual clause during
+// propagation.  It can be configured with './configure
+// --watcher-literals=<n>' and larger values trade watcher size for fewer
+// clause accesses.  The 'visits' metrics report how often the clause
+// still had to be accessed.
+
+#ifndef SIZE_WATCHER_LITERALS
 #define SIZE_WATCHER_LITERALS 4
+#endif
+
+#if SIZE_WATCHER_LITERALS < 3 || SIZE_WATCHER_LITERALS > 15
+#error "'SIZE_WATCHER_LITERALS' needs to be in the range '3..15'"
+#endif
 #define MAX_USED 31
 
+// Watchers are split into a hot part accessed during propagation and a
+// cold part (with the same index) which is only needed during conflict
+// analysis, reduction and vivification.  This way two hot watchers fit
+// into one cache line.
+
 struct watcher {
   unsigned char size;
-  unsigned char glue;
-  unsigned char used;
   bool garbage : 1;
   bool reason : 1;
   bool redundant : 1;
-  bool vivify : 1;
   unsigned sum;
   struct clause *clause;
   unsigned aux[SIZE_WATCHER_LITERALS];
@@ -30,11 +45,23 @@ struct watchers {
   struct watcher *begin, *end, *allocated;
 };
 
+struct watcher_usage {
+  unsigned char glue;
+  unsigned char used;
+  bool vivify;
+  unsigned short source;
+};
+
+struct watcher_usages {
+  struct watcher_usage *begin, *end, *allocated;
+};
+
 /*------------------------------------------------------------------------*/
 
 struct saved_watcher {
   unsigned char used;
   bool vivify;
+  unsigned short source;
   struct clause *clause;
 };
 
@@ -50,9 +77,15 @@ struct watches {
   struct watch **begin, **end, **allocated;
 };
 
+// Large clause watches, the shared irredundant binary clauses and the
+// ring local redundant binary clauses (only the other literal) of a
+// literal.  The first four fields are shared with 'struct counters' of
+// the local search walker in 'walk.c' (which casts these references).
+
 struct references {
   struct watch **begin, **end, **allocated;
   unsigned *binaries;
+  struct unsigneds redundant;
 };
 
 /*------------------------------------------------------------------------*/
@@ -74,6 +107,8 @@ struct references {
 
 struct watch *new_local_binary_clause (struct ring *ring, bool redundant,
                                        unsigned lit, unsigned other);
+struct watch *new_learned_binary_clause (struct ring *, unsigned lit,
+                                         unsigned other);
 
 struct watch *watch_literals_in_large_clause (struct ring *,
                                               struct clause *,
@@ -96,10 +131,12 @@ void sort_redundant_watcher_indices (struct ring *, size_t, unsigned *);
 /*------------------------------------------------------------------------*/
 
 static inline struct saved_watcher
-saved_watcher_from_watcher (struct watcher *watcher) {
+saved_watcher_from_watcher (struct watcher *watcher,
+                            struct watcher_usage *usage) {
   struct saved_watcher res;
-  res.used = watcher->used;
-  res.vivify = watcher->vivify;
+  res.used = usage->used;
+  res.vivify = usage->vivify;
+  res.source = usage->source;
   res.clause = watcher->clause;
   return res;
 }
@@ -110,6 +147,7 @@ saved_watcher_from_binary (void *binary) {
   struct saved_watcher res;
   res.used = 0;
   res.vivify = false;
+  res.source = 0;
   res.clause = (struct clause *) binary;
   return res;
 }
@@ -13,12 +13,14 @@ signed char *extend_witness (struct ring *ring) {
   struct ruler *ruler = ring->ruler;
   LOG ("extending witness from %u to %u variables", ring->size,
        ruler->size);
-  signed char *witness = allocate_array (2 * ruler->size, sizeof *witness);
+  unsigned variables = ruler->size + ruler->fresh;
+  signed char *witness = allocate_array (2 * variables, sizeof *witness);
   signed char *values = ring->values;
   assert (ring->size == ruler->compact);
   signed char phase = initial_phase (ring);
-  LOG ("setting all %u original variables to %d", ruler->size, phase);
-  for (unsigned idx = 0; idx != ruler->size; idx++) {
+  LOG ("setting all %u original and %u fresh variables to %d",
+       ruler->size, ruler->fresh, phase);
+  for (unsigned idx = 0; idx != variables; idx++) {
     unsigned lit = LIT (idx);
     unsigned not_lit = NOT (lit);
     witness[lit] = phase;
@@ -126,6 +128,18 @@ signed char *extend_witness (struct ring *ring) {
   return witness;
 }
 
+bool satisfies_original (signed char *values, struct unsigneds *original) {
+  for (unsigned *c = original->begin, *p; c != original->end; c = p + 1) {
+    bool satisfied = false;
+    for (p = c; *p != INVALID; p++)
+      if (values[*p] > 0)
+        satisfied = true;
+    if (!satisfied)
+      return false;
+  }
+  return true;
+}
+
 #ifndef NDEBUG
 
 void check_witness (signed char *values, struct unsigneds *original) {
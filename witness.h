@@ -1,14 +1,18 @@
 #ifndef _witness_h_INCLUDED
 #define _witness_h_INCLUDED
 
+#include <stdbool.h>
+
 struct ring;
 
 signed char *extend_witness (struct ring *);
 void print_witness (unsigned size, signed char *values);
 
+struct unsigneds;
+bool satisfies_original (signed char *values, struct unsigneds *);
+
 #ifndef NDEBUG
 
-struct unsigneds;
 void check_witness (signed char *values, struct unsigneds *);
 
 #else